@@ -27,6 +27,11 @@ typedef struct
                                                  This parameter must range from 1 to 16. */
 } ADC_Config_t;
 
+/*
+ * Maximum ADC kernel clock (datasheet)
+ */
+#define ADC_MAX_CLOCK_FREQ                  14000000U
+
 /*
  * @ref ADC_mode
  */
@@ -0,0 +1,31 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "stm32f1xx.h"
+
+#define BOOT_PROFILE_MAGIC      0xB0075EEDU
+
+/*
+ * Boot phase timestamps, written by the reset handler into .noinit (which
+ * the C runtime init does not touch). Each field is the DWT cycle count
+ * since reset entry at the end of that phase. The counter runs at 8MHz
+ * until SystemInit switches to the PLL, so ClockCycles is in HSI cycles
+ * and the later fields mix both clocks.
+ * Field order is fixed: startup_stm32f103c8t6.S stores by offset.
+ */
+typedef struct {
+    uint32_t Magic;             /*!< BOOT_PROFILE_MAGIC once the reset handler has run */
+    uint32_t ClockCycles;       /*!< SystemInit done (PLL running) */
+    uint32_t DataCycles;        /*!< .data copied */
+    uint32_t RamfuncCycles;     /*!< .ramfunc copied */
+    uint32_t BssCycles;         /*!< .bss zeroed */
+    uint32_t MainCycles;        /*!< About to call main */
+} BOOT_Profile_t;
+
+/*
+ * APIs
+ */
+const BOOT_Profile_t *BOOT_GetProfile(void);
+uint32_t BOOT_GetCyclesToMain(void);
+
+#endif // BOOT_H
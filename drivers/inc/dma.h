@@ -29,6 +29,8 @@ typedef struct
                                           This parameter can be a value of @ref DMA_priority_level */
     uint32_t DMA_M2M;                /*!< Specifies if the DMAy Channelx will be used in memory-to-memory transfer.
                                           This parameter can be a value of @ref DMA_memory_to_memory */
+    uint32_t DMA_IT;                 /*!< Specifies the channel interrupts enabled by DMA_Init.
+                                          This parameter can be 0 or any combination of @ref DMA_interrupts */
 } DMA_Init_t;
 
 /*
@@ -83,11 +85,89 @@ typedef struct
 #define DMA_M2M_Enable              ((uint32_t)0x00004000)
 #define DMA_M2M_Disable             ((uint32_t)0x00000000)
 
+/*
+ * DMA_interrupts
+ */
+#define DMA_IT_TC                   ((uint32_t)0x00000002)
+#define DMA_IT_HT                   ((uint32_t)0x00000004)
+#define DMA_IT_TE                   ((uint32_t)0x00000008)
+
+/*
+ * DMA CCR bits
+ */
+#define DMA_CCR_EN                  ((uint32_t)0x00000001)
+
+/*
+ * DMA_flags (ISR/IFCR), Channel = 1..7
+ */
+#define DMA_FLAG_GL(Channel)        ((uint32_t)0x1 << (4U * ((Channel) - 1U)))
+#define DMA_FLAG_TC(Channel)        ((uint32_t)0x2 << (4U * ((Channel) - 1U)))
+#define DMA_FLAG_HT(Channel)        ((uint32_t)0x4 << (4U * ((Channel) - 1U)))
+#define DMA_FLAG_TE(Channel)        ((uint32_t)0x8 << (4U * ((Channel) - 1U)))
+
+/*
+ * @ref DMA_Requests
+ * DMA1 request lines of the STM32F103 (RM0008 table 78) and the channel
+ * each one is wired to. DMA_REQ_MEM2MEM is not a peripheral request and
+ * takes any free channel.
+ */
+#define DMA_REQ_ADC1                0   /*!< Channel 1 */
+#define DMA_REQ_SPI1_RX             1   /*!< Channel 2 */
+#define DMA_REQ_SPI1_TX             2   /*!< Channel 3 */
+#define DMA_REQ_SPI2_RX             3   /*!< Channel 4 */
+#define DMA_REQ_SPI2_TX             4   /*!< Channel 5 */
+#define DMA_REQ_USART1_TX           5   /*!< Channel 4 */
+#define DMA_REQ_USART1_RX           6   /*!< Channel 5 */
+#define DMA_REQ_USART2_TX           7   /*!< Channel 7 */
+#define DMA_REQ_USART2_RX           8   /*!< Channel 6 */
+#define DMA_REQ_USART3_TX           9   /*!< Channel 2 */
+#define DMA_REQ_USART3_RX           10  /*!< Channel 3 */
+#define DMA_REQ_I2C1_TX             11  /*!< Channel 6 */
+#define DMA_REQ_I2C1_RX             12  /*!< Channel 7 */
+#define DMA_REQ_I2C2_TX             13  /*!< Channel 4 */
+#define DMA_REQ_I2C2_RX             14  /*!< Channel 5 */
+#define DMA_REQ_TIM1_UP             15  /*!< Channel 5 */
+#define DMA_REQ_TIM2_UP             16  /*!< Channel 2 */
+#define DMA_REQ_TIM3_UP             17  /*!< Channel 3 */
+#define DMA_REQ_TIM4_UP             18  /*!< Channel 7 */
+#define DMA_REQ_MEM2MEM             19  /*!< Any free channel, highest number first */
+#define DMA_REQ_COUNT               20
+
+#define DMA1_CHANNEL_COUNT          7U
+#define DMA_CHANNEL_NONE            0U  /*!< Returned by DMA_Claim when the channel is taken */
+
+/*
+ * Channel interrupt priority set by DMA_Claim. Callbacks take BASEPRI
+ * critical sections, so it must not preempt NVIC_CRITICAL_PRIORITY.
+ */
+#ifndef DMA_IRQ_PRIORITY
+#define DMA_IRQ_PRIORITY            NVIC_CRITICAL_PRIORITY
+#endif
+
+/*
+ * Channel event callback, called from the DMA1 channel interrupt with the
+ * channel number (1..7) and the context given to DMA_SetCallbacks
+ */
+typedef void (*DMA_Callback_t)(uint8_t Channel, void *pContext);
+
 /*
  * Function Prototypes
  */
 void DMA_Init(DMA_Channel_TypeDef* DMAy_Channelx, DMA_Init_t* DMA_InitStruct);
 void DMA_DeInit(DMA_Channel_TypeDef* DMAy_Channelx);
 void DMA_Cmd(DMA_Channel_TypeDef* DMAy_Channelx, uint8_t NewState);
+void DMA_ITConfig(DMA_Channel_TypeDef* DMAy_Channelx, uint32_t DMA_IT, uint8_t NewState);
+uint8_t DMA_GetFlagStatus(DMA_TypeDef* DMAy, uint32_t DMA_FLAG);
+void DMA_ClearFlag(DMA_TypeDef* DMAy, uint32_t DMA_FLAG);
+
+// Channel manager (DMA1)
+uint8_t DMA_GetRequestChannel(uint8_t Request);
+uint8_t DMA_Claim(uint8_t Request);
+void DMA_Release(uint8_t Channel);
+void DMA_SetCallbacks(uint8_t Channel, DMA_Callback_t pfnHalf, DMA_Callback_t pfnComplete,
+                      DMA_Callback_t pfnError, void *pContext);
+DMA_Channel_TypeDef *DMA_GetChannel(uint8_t Channel);
+uint16_t DMA_GetRemaining(uint8_t Channel);
+void DMA_IRQHandling(uint8_t Channel);
 
 #endif // DMA_H
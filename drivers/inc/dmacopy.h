@@ -0,0 +1,69 @@
+#ifndef DMACOPY_H
+#define DMACOPY_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Asynchronous memory copy and fill on a memory-to-memory DMA1 channel.
+ * Requests are queued and run one after the other while the CPU carries
+ * on; each one completes with a callback from the DMA interrupt. The
+ * transfer width (byte, half-word, word) follows the common alignment of
+ * the addresses; the odd tail bytes are done by the CPU up front.
+ * Requests shorter than the CPU threshold are done with memcpy/memset on
+ * the spot: below it, setting up the DMA and taking its interrupt costs
+ * the CPU more than the copy itself (see Bench_DmaCopy).
+ */
+#ifndef DMACPY_CPU_THRESHOLD
+#define DMACPY_CPU_THRESHOLD    128U    /*!< Bytes; default until DMACPY_SetCpuThreshold */
+#endif
+
+/* Completion interrupt; must not preempt NVIC_CRITICAL_PRIORITY (the queue lock) */
+#ifndef DMACPY_IRQ_PRIORITY
+#define DMACPY_IRQ_PRIORITY     NVIC_CRITICAL_PRIORITY
+#endif
+
+#define DMACPY_MAX_ITEMS        0xFFFFU /*!< CNDTR limit, longer requests run in chunks */
+
+typedef enum
+{
+  DMACPY_OK = 0,        /*!< Queued */
+  DMACPY_DONE,          /*!< Completed; from the Async calls: by the CPU, callback already called */
+  DMACPY_BUSY,          /*!< Request still queued or running */
+  DMACPY_ERROR          /*!< Not initialised, or a DMA transfer error */
+} DMACPY_Status;
+
+struct DMACPY_Request;
+typedef void (*DMACPY_Callback_t)(struct DMACPY_Request *pReq, void *pContext);
+
+/*
+ * Copy/fill request, owned by the caller until its callback has run.
+ * The buffers must stay valid for as long.
+ */
+typedef struct DMACPY_Request {
+    struct DMACPY_Request *pNext;
+    uint8_t *pDst;
+    const uint8_t *pSrc;            /*!< Copy source, or &Fill for a fill */
+    uint32_t Len;                   /*!< Bytes left for the DMA */
+    uint32_t Fill;                  /*!< Fill byte replicated to the transfer width */
+    DMACPY_Callback_t pfnDone;      /*!< Runs in the DMA interrupt (or the caller for DMACPY_DONE) */
+    void *pContext;
+    uint32_t Chunk;                 /*!< Bytes of the transfer in flight */
+    uint8_t Width;                  /*!< 1, 2 or 4 bytes per DMA item */
+    uint8_t IsFill;
+    volatile uint8_t Busy;
+    volatile DMACPY_Status Status;  /*!< DMACPY_DONE or DMACPY_ERROR once finished */
+} DMACPY_Request_t;
+
+/*
+ * APIs
+ */
+DMACPY_Status DMACPY_Init(void);
+DMACPY_Status DMACPY_MemcpyAsync(DMACPY_Request_t *pReq, void *pDst, const void *pSrc, uint32_t Len,
+                                 DMACPY_Callback_t pfnDone, void *pContext);
+DMACPY_Status DMACPY_MemsetAsync(DMACPY_Request_t *pReq, void *pDst, uint8_t Value, uint32_t Len,
+                                 DMACPY_Callback_t pfnDone, void *pContext);
+uint8_t DMACPY_IsBusy(const DMACPY_Request_t *pReq);
+void DMACPY_SetCpuThreshold(uint32_t Bytes);
+uint32_t DMACPY_GetCpuThreshold(void);
+
+#endif // DMACOPY_H
@@ -0,0 +1,66 @@
+#ifndef DMALIST_H
+#define DMALIST_H
+
+#include "stm32f1xx.h"
+#include "dma.h"
+
+/*
+ * Software-chained DMA transfers. The F1 DMA has no descriptors, so the
+ * transfer-complete interrupt moves the channel to the next node itself:
+ * disable, CMAR/CNDTR from the node, enable, before anything else runs.
+ * The peripheral side (CPAR) and the channel settings stay fixed for the
+ * whole list. A node whose pNext points back into the list makes a ring
+ * that streams until DMAL_Stop.
+ */
+typedef enum
+{
+  DMAL_OK = 0,
+  DMAL_BUSY,            /*!< Channel claimed by another driver, or list running */
+  DMAL_ERROR            /*!< Invalid argument */
+} DMAL_Status;
+
+/*
+ * One buffer of the list, owned by the caller
+ */
+typedef struct DMAL_Node {
+    struct DMAL_Node *pNext;    /*!< Next node, 0 ends the list */
+    uint32_t MemoryAddr;        /*!< Buffer, goes to CMAR */
+    uint16_t Count;             /*!< Data items (CNDTR), not 0 */
+} DMAL_Node_t;
+
+struct DMAL_List;
+typedef void (*DMAL_Callback_t)(struct DMAL_List *pList, DMAL_Node_t *pNode, void *pContext);
+
+/*
+ * List state. pfnNodeDone is called from the DMA interrupt for each
+ * finished node, after the next one has already been started; it must be
+ * done with the buffer before the ring comes back to it.
+ */
+typedef struct DMAL_List {
+    DMA_Channel_TypeDef *pChannel;
+    uint32_t CcrRun;                /*!< CCR with EN and TC/TE interrupts */
+    DMAL_Node_t *volatile pCurrent; /*!< Node owned by the channel */
+    DMAL_Callback_t pfnNodeDone;
+    DMAL_Callback_t pfnError;       /*!< Transfer error, the list has stopped */
+    void *pContext;
+    volatile uint32_t NodesDone;
+    uint8_t Channel;
+    volatile uint8_t Running;
+} DMAL_List_t;
+
+/*
+ * APIs
+ */
+DMAL_Status DMAL_Init(DMAL_List_t *pList, uint8_t Request, const DMA_Init_t *pInit,
+                      DMAL_Callback_t pfnNodeDone, DMAL_Callback_t pfnError, void *pContext);
+void DMAL_DeInit(DMAL_List_t *pList);
+DMAL_Status DMAL_Start(DMAL_List_t *pList, DMAL_Node_t *pFirst);
+void DMAL_Stop(DMAL_List_t *pList);
+uint8_t DMAL_IsRunning(const DMAL_List_t *pList);
+
+// Presets
+void DMAL_BuildChain(DMAL_Node_t *pNodes, uint8_t *const *ppBuffers, uint8_t NumNodes, uint16_t Count);
+void DMAL_BuildRing(DMAL_Node_t *pNodes, uint8_t *const *ppBuffers, uint8_t NumNodes, uint16_t Count);
+void DMAL_BuildPingPong(DMAL_Node_t pNodes[2], uint8_t *pPing, uint8_t *pPong, uint16_t Count);
+
+#endif // DMALIST_H
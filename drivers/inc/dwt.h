@@ -0,0 +1,39 @@
+#ifndef DWT_H
+#define DWT_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Min/max/average accumulator for profiling a code path in core cycles
+ */
+typedef struct {
+    uint32_t Count;
+    uint32_t Min;
+    uint32_t Max;
+    uint64_t Total;
+} DWT_CycleStats_t;
+
+/*
+ * Function Prototypes
+ */
+void DWT_Init(void);
+
+/**
+ * @brief  Current value of the free-running core cycle counter
+ *         (wraps every 2^32 cycles, ~59.6 s at 72MHz)
+ */
+static inline uint32_t cycles_now(void) {
+    return DWT->CYCCNT;
+}
+
+void delay_cycles(uint32_t cycles);
+uint32_t us_to_cycles(uint32_t us);
+uint32_t cycles_to_us(uint32_t cycles);
+uint32_t cycles_to_ns(uint32_t cycles);
+
+// Profiling
+void DWT_CycleStatsReset(DWT_CycleStats_t *pStats);
+void DWT_CycleStatsAdd(DWT_CycleStats_t *pStats, uint32_t cycles);
+uint32_t DWT_CycleStatsAverage(const DWT_CycleStats_t *pStats);
+
+#endif // DWT_H
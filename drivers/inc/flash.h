@@ -2,6 +2,7 @@
 #define FLASH_H
 
 #include "stm32f1xx.h"
+#include "pt.h"
 
 /*
  * FLASH Status
@@ -29,6 +30,24 @@ typedef enum
 #define FLASH_KEY1             ((uint32_t)0x45670123)
 #define FLASH_KEY2             ((uint32_t)0xCDEF89AB)
 
+/*
+ * Page erase timeout of the resumable erase (ms); typical erase is 20-40 ms
+ */
+#ifndef FLASH_PT_ERASE_TIMEOUT_MS
+#define FLASH_PT_ERASE_TIMEOUT_MS 50U
+#endif
+
+/*
+ * Resumable page erase: state for FLASH_ErasePage_PT (kept by the caller)
+ */
+typedef struct
+{
+    pt_t pt;
+    uint32_t PageAddress;
+    timeout_t Timeout;
+    FLASH_Status Status;      /*!< Result once the coroutine has ended */
+} FLASH_EraseReq_t;
+
 /*
  * Function Prototypes
  */
@@ -40,4 +59,8 @@ FLASH_Status FLASH_ProgramWord(uint32_t Address, uint32_t Data);
 FLASH_Status FLASH_GetStatus(void);
 FLASH_Status FLASH_WaitForLastOperation(uint32_t Timeout);
 
+// Resumable erase
+void FLASH_ErasePageStart(FLASH_EraseReq_t *pReq, uint32_t Page_Address);
+char FLASH_ErasePage_PT(FLASH_EraseReq_t *pReq);
+
 #endif // FLASH_H
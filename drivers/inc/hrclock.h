@@ -0,0 +1,27 @@
+#ifndef HRCLOCK_H
+#define HRCLOCK_H
+
+#include "stm32f1xx.h"
+#include "timer.h"
+
+/*
+ * Free-running microsecond clock: TIM2 counts at 1MHz and clocks TIM3 on
+ * every overflow (TRGO = update, TIM3 external clock mode 1 on ITR1).
+ * The pair forms a 32-bit hardware counter (~71.6 min); a software word
+ * bumped on the TIM3 overflow extends it to 64 bits.
+ */
+#define HRC_FREQ_HZ             1000000U
+#define HRC_LOW_TIM             TIM2
+#define HRC_HIGH_TIM            TIM3
+#define HRC_HIGH_TRIGGER        TIM_TS_ITR1   /*!< TIM3 ITR1 = TIM2 TRGO */
+
+/*
+ * Function Prototypes
+ */
+void HRC_Init(void);
+uint32_t HRC_Now32(void);
+uint64_t HRC_Now64(void);
+uint64_t HRC_ExtendCapture(uint16_t Capture);
+void HRC_IRQHandler(void);
+
+#endif // HRCLOCK_H
@@ -2,6 +2,7 @@
 #define I2C_H
 
 #include "stm32f1xx.h"
+#include "pt.h"
 
 /*
  * I2C Configuration Structure
@@ -65,6 +66,50 @@ typedef struct
 #define I2C_SR1_TIMEOUT             ((uint16_t)0x4000)
 #define I2C_SR1_SMBALERT            ((uint16_t)0x8000)
 
+/*
+ * I2C Status Register 2 / Control Register 1 bits used by the coroutines
+ */
+#define I2C_SR2_BUSY                ((uint16_t)0x0002)
+#define I2C_CR1_START               ((uint16_t)0x0100)
+#define I2C_CR1_STOP                ((uint16_t)0x0200)
+#define I2C_CR1_ACK                 ((uint16_t)0x0400)
+#define I2C_CR1_POS                 ((uint16_t)0x0800)
+
+/*
+ * Per-step timeout of the resumable transfers (ms)
+ */
+#ifndef I2C_PT_TIMEOUT_MS
+#define I2C_PT_TIMEOUT_MS           10U
+#endif
+
+/*
+ * I2C Status
+ */
+typedef enum
+{
+  I2C_OK = 0,
+  I2C_BUSY,
+  I2C_NACK,
+  I2C_TIMEOUT,
+  I2C_ERROR
+} I2C_Status;
+
+/*
+ * Resumable register read: state for I2C_ReadReg_PT (kept by the caller)
+ */
+typedef struct
+{
+    pt_t pt;
+    I2C_TypeDef *I2Cx;
+    uint8_t DevAddress;               /*!< 8-bit bus address, R/W bit clear */
+    uint8_t Reg;
+    uint8_t *pData;
+    uint16_t Len;
+    uint16_t Index;
+    timeout_t Timeout;
+    I2C_Status Status;                /*!< Result once the coroutine has ended */
+} I2C_ReadReg_t;
+
 /*
  * Function Prototypes
  */
@@ -76,4 +121,8 @@ void I2C_SendData(I2C_TypeDef* I2Cx, uint8_t Data);
 uint8_t I2C_ReceiveData(I2C_TypeDef* I2Cx);
 uint8_t I2C_CheckEvent(I2C_TypeDef* I2Cx, uint32_t I2C_EVENT);
 
+// Resumable transfers
+void I2C_ReadRegStart(I2C_ReadReg_t *pReq, I2C_TypeDef* I2Cx, uint8_t DevAddress, uint8_t Reg, uint8_t *pData, uint16_t Len);
+char I2C_ReadReg_PT(I2C_ReadReg_t *pReq);
+
 #endif // I2C_H
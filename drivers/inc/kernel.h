@@ -0,0 +1,125 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Fixed-priority preemptive kernel.
+ * One task per priority level, 0 is the highest. Priority OS_PRIO_IDLE is
+ * taken by the built-in idle task. Tasks run on PSP, handlers on MSP;
+ * PendSV (lowest priority) switches context, SVC launches the first task.
+ * Critical sections raise BASEPRI to NVIC_CRITICAL_PRIORITY: ISRs that call
+ * the ISR-safe APIs must run at that priority or lower (numerically >=).
+ */
+#define OS_MAX_TASKS            32U
+#define OS_PRIO_IDLE            (OS_MAX_TASKS - 1U)
+
+#ifndef OS_IDLE_STACK_WORDS
+#define OS_IDLE_STACK_WORDS     64U
+#endif
+
+#define OS_WAIT_FOREVER         0xFFFFFFFFU
+#define OS_NO_WAIT              0U
+
+/*
+ * Kernel Status
+ */
+typedef enum
+{
+  OS_OK = 0,
+  OS_TIMEOUT,
+  OS_ERROR_PARAM,
+  OS_ERROR_PRIO_USED,
+  OS_ERROR_NOT_OWNER
+} OS_Status;
+
+/*
+ * Task states
+ */
+#define OS_TASK_DORMANT         0
+#define OS_TASK_READY           1
+#define OS_TASK_DELAYED         2   /*!< In OS_Delay */
+#define OS_TASK_BLOCKED         3   /*!< Waiting on a semaphore, mutex or queue */
+
+/*
+ * Task control block, owned by the caller (static)
+ */
+typedef struct {
+    uint32_t *pSP;                  /*!< Saved PSP, must stay the first member (used by PendSV) */
+    volatile uint32_t DelayTicks;   /*!< Remaining delay or wait timeout */
+    volatile uint32_t *pWaitMask;   /*!< Wait mask of the object blocked on, 0 if none */
+    void *pWaitData;                /*!< Item being sent or received while blocked on a queue */
+    volatile OS_Status WaitResult;
+    uint8_t Priority;
+    volatile uint8_t State;
+} OS_Task_t;
+
+/*
+ * Counting semaphore; OS_SemGive may be called from interrupts
+ */
+typedef struct {
+    volatile uint32_t Count;
+    volatile uint32_t WaitMask;     /*!< One bit per waiting task priority */
+} OS_Sem_t;
+
+/*
+ * Recursive mutex (no priority inheritance: keep the locked sections short)
+ */
+typedef struct {
+    OS_Task_t *volatile pOwner;
+    uint32_t Nesting;
+    volatile uint32_t WaitMask;
+} OS_Mutex_t;
+
+/*
+ * Fixed-size message queue over a caller-provided buffer.
+ * OS_QueueSend/Receive with OS_NO_WAIT may be called from interrupts.
+ */
+typedef struct {
+    uint8_t *pBuffer;
+    uint16_t ItemSize;
+    uint16_t Capacity;              /*!< Number of items pBuffer holds */
+    uint16_t Head;
+    uint16_t Tail;
+    volatile uint16_t Count;
+    volatile uint32_t RecvWaitMask;
+    volatile uint32_t SendWaitMask;
+} OS_Queue_t;
+
+/*
+ * Function Prototypes
+ */
+// Tasks
+OS_Status OS_TaskCreate(OS_Task_t *pTask, void (*pfnEntry)(void *pArg), void *pArg,
+                        uint32_t *pStack, uint32_t StackWords, uint8_t Priority);
+void OS_Start(void);
+void OS_Delay(uint32_t Ticks);
+OS_Task_t *OS_GetCurrentTask(void);
+uint8_t OS_IsRunning(void);
+void OS_Tick(void);
+
+// Semaphore
+void OS_SemInit(OS_Sem_t *pSem, uint32_t InitialCount);
+OS_Status OS_SemTake(OS_Sem_t *pSem, uint32_t Timeout);
+void OS_SemGive(OS_Sem_t *pSem);
+
+// Mutex
+void OS_MutexInit(OS_Mutex_t *pMutex);
+OS_Status OS_MutexLock(OS_Mutex_t *pMutex, uint32_t Timeout);
+OS_Status OS_MutexUnlock(OS_Mutex_t *pMutex);
+
+// Queue
+void OS_QueueInit(OS_Queue_t *pQueue, void *pBuffer, uint16_t ItemSize, uint16_t Capacity);
+OS_Status OS_QueueSend(OS_Queue_t *pQueue, const void *pItem, uint32_t Timeout);
+OS_Status OS_QueueReceive(OS_Queue_t *pQueue, void *pItem, uint32_t Timeout);
+
+// Application hook, runs in the idle task (default: WFI)
+void OS_IdleHook(void);
+
+// Runs at the start of every PendSV, before the context switch; the default
+// calls the hook installed with OS_SetPendSVHook (WQ_Init installs WQ_Run)
+typedef void (*OS_Hook_t)(void);
+void OS_SetPendSVHook(OS_Hook_t pfnHook);
+void PendSV_Callback(void);
+
+#endif // KERNEL_H
@@ -0,0 +1,253 @@
+#ifndef LFQUEUE_H
+#define LFQUEUE_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Lock-free fixed-capacity queues for handing data from interrupts to
+ * thread code without masking interrupts.
+ *
+ *  - LFQ_Spsc_t:         byte ring, one producer and one consumer.
+ *  - LFQ_SPSC_DEFINE():  element ring of a given type, one producer and
+ *                        one consumer, element size fixed at compile time.
+ *  - LFQ_Mpsc_t:         32-bit word queue, any number of producers (ISRs
+ *                        of any priority) and one consumer; slots are
+ *                        claimed with LDREX/STREX.
+ *
+ * Capacities must be powers of two. Indices run freely and are masked on
+ * access, so a full ring holds all Size entries.
+ *
+ * On the Cortex-M3 producer and consumer share one core, so ordering only
+ * needs a compiler barrier; elsewhere (host builds) real fences are used.
+ */
+#if defined(__arm__)
+#define LFQ_ACQUIRE()       COMPILER_BARRIER()
+#define LFQ_RELEASE()       COMPILER_BARRIER()
+#else
+#define LFQ_ACQUIRE()       __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define LFQ_RELEASE()       __atomic_thread_fence(__ATOMIC_RELEASE)
+#endif
+
+/*
+ * SPSC byte ring over a caller-provided buffer
+ */
+typedef struct {
+    uint8_t *pBuffer;
+    uint16_t Mask;                  /*!< Size - 1 */
+    volatile uint16_t Head;         /*!< Written by the producer only */
+    volatile uint16_t Tail;         /*!< Written by the consumer only */
+} LFQ_Spsc_t;
+
+static inline void LFQ_SpscInit(LFQ_Spsc_t *pQ, uint8_t *pBuffer, uint16_t Size) {
+    pQ->pBuffer = pBuffer;
+    pQ->Mask = (uint16_t)(Size - 1U);
+    pQ->Head = 0;
+    pQ->Tail = 0;
+}
+
+static inline uint16_t LFQ_SpscCount(const LFQ_Spsc_t *pQ) {
+    return (uint16_t)(pQ->Head - pQ->Tail);
+}
+
+static inline uint16_t LFQ_SpscFree(const LFQ_Spsc_t *pQ) {
+    return (uint16_t)(pQ->Mask + 1U - (uint16_t)(pQ->Head - pQ->Tail));
+}
+
+/* Producer side; returns 0 when the ring is full */
+static inline uint8_t LFQ_SpscPut(LFQ_Spsc_t *pQ, uint8_t Byte) {
+    uint16_t head = pQ->Head;
+
+    if ((uint16_t)(head - pQ->Tail) > pQ->Mask) {
+        return 0;
+    }
+    LFQ_ACQUIRE();
+    pQ->pBuffer[head & pQ->Mask] = Byte;
+    LFQ_RELEASE();
+    pQ->Head = (uint16_t)(head + 1U);
+    return 1;
+}
+
+/* Consumer side; returns 0 when the ring is empty */
+static inline uint8_t LFQ_SpscGet(LFQ_Spsc_t *pQ, uint8_t *pByte) {
+    uint16_t tail = pQ->Tail;
+
+    if (pQ->Head == tail) {
+        return 0;
+    }
+    LFQ_ACQUIRE();
+    *pByte = pQ->pBuffer[tail & pQ->Mask];
+    LFQ_RELEASE();
+    pQ->Tail = (uint16_t)(tail + 1U);
+    return 1;
+}
+
+/* Producer side; queues up to Len bytes and returns how many fitted */
+static inline uint16_t LFQ_SpscWrite(LFQ_Spsc_t *pQ, const uint8_t *pData, uint16_t Len) {
+    uint16_t head = pQ->Head;
+    uint16_t space = (uint16_t)(pQ->Mask + 1U - (uint16_t)(head - pQ->Tail));
+    uint16_t count = (Len < space) ? Len : space;
+
+    LFQ_ACQUIRE();
+    for (uint16_t i = 0; i < count; i++) {
+        pQ->pBuffer[(uint16_t)(head + i) & pQ->Mask] = pData[i];
+    }
+    LFQ_RELEASE();
+    pQ->Head = (uint16_t)(head + count);
+    return count;
+}
+
+/* Consumer side; takes up to Len bytes and returns how many were copied */
+static inline uint16_t LFQ_SpscRead(LFQ_Spsc_t *pQ, uint8_t *pData, uint16_t Len) {
+    uint16_t tail = pQ->Tail;
+    uint16_t avail = (uint16_t)(pQ->Head - tail);
+    uint16_t count = (Len < avail) ? Len : avail;
+
+    LFQ_ACQUIRE();
+    for (uint16_t i = 0; i < count; i++) {
+        pData[i] = pQ->pBuffer[(uint16_t)(tail + i) & pQ->Mask];
+    }
+    LFQ_RELEASE();
+    pQ->Tail = (uint16_t)(tail + count);
+    return count;
+}
+
+/*
+ * SPSC element ring with the storage embedded, e.g.
+ *
+ *     LFQ_SPSC_DEFINE(AdcQueue, uint16_t, 32);
+ *     static AdcQueue_t g_adc_queue;
+ *     AdcQueue_Put(&g_adc_queue, &sample);         // ISR
+ *     while (AdcQueue_Get(&g_adc_queue, &s)) {}    // main loop
+ *
+ * The invocation ends with ';' like any declaration. Elements are copied
+ * by assignment, so any complete type works.
+ */
+#define LFQ_SPSC_DEFINE(name, type, size) \
+    typedef struct { \
+        type Items[(size)]; \
+        volatile uint16_t Head; \
+        volatile uint16_t Tail; \
+    } name##_t; \
+    \
+    static inline uint16_t name##_Count(const name##_t *pQ) { \
+        return (uint16_t)(pQ->Head - pQ->Tail); \
+    } \
+    \
+    static inline uint8_t name##_Put(name##_t *pQ, const type *pItem) { \
+        uint16_t head = pQ->Head; \
+        if ((uint16_t)(head - pQ->Tail) >= (uint16_t)(size)) { \
+            return 0; \
+        } \
+        LFQ_ACQUIRE(); \
+        pQ->Items[head & ((size) - 1U)] = *pItem; \
+        LFQ_RELEASE(); \
+        pQ->Head = (uint16_t)(head + 1U); \
+        return 1; \
+    } \
+    \
+    static inline uint8_t name##_Get(name##_t *pQ, type *pItem) { \
+        uint16_t tail = pQ->Tail; \
+        if (pQ->Head == tail) { \
+            return 0; \
+        } \
+        LFQ_ACQUIRE(); \
+        *pItem = pQ->Items[tail & ((size) - 1U)]; \
+        LFQ_RELEASE(); \
+        pQ->Tail = (uint16_t)(tail + 1U); \
+        return 1; \
+    } \
+    \
+    typedef char name##_SizeCheck[(((size) & ((size) - 1U)) == 0 && (size) <= 0x8000U) ? 1 : -1]
+
+/*
+ * MPSC word queue (bounded, per-slot sequence numbers).
+ * A producer claims slot Head with LDREX/STREX, fills it and then stamps
+ * its sequence; the consumer only takes a slot once it is stamped, so a
+ * producer preempted between claim and stamp delays the consumer but
+ * never exposes a half-written entry.
+ */
+typedef struct {
+    volatile uint32_t Seq;
+    uint32_t Data;
+} LFQ_MpscCell_t;
+
+typedef struct {
+    LFQ_MpscCell_t *pCells;
+    uint32_t Mask;                  /*!< Size - 1 */
+    volatile uint32_t Head;         /*!< Next slot to claim, shared by producers */
+    uint32_t Tail;                  /*!< Next slot to take, consumer only */
+} LFQ_Mpsc_t;
+
+#if defined(__arm__)
+// Helper to compare-and-swap a word; exception entry clears the monitor, so a preempted attempt just retries
+static inline uint8_t LFQ_CompareAndSwap(volatile uint32_t *pAddr, uint32_t Expected, uint32_t Desired) {
+    uint32_t value;
+    uint32_t failed;
+
+    __asm volatile ("ldrex %0, [%1]" : "=r" (value) : "r" (pAddr) : "memory");
+    if (value != Expected) {
+        __asm volatile ("clrex" ::: "memory");
+        return 0;
+    }
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (failed) : "r" (pAddr), "r" (Desired) : "memory");
+    return (uint8_t)(failed == 0);
+}
+#else
+static inline uint8_t LFQ_CompareAndSwap(volatile uint32_t *pAddr, uint32_t Expected, uint32_t Desired) {
+    return (uint8_t)__atomic_compare_exchange_n(pAddr, &Expected, Desired, 0,
+                                                __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+#endif
+
+static inline void LFQ_MpscInit(LFQ_Mpsc_t *pQ, LFQ_MpscCell_t *pCells, uint32_t Size) {
+    for (uint32_t i = 0; i < Size; i++) {
+        pCells[i].Seq = i;
+    }
+    pQ->pCells = pCells;
+    pQ->Mask = Size - 1U;
+    pQ->Head = 0;
+    pQ->Tail = 0;
+}
+
+/* Producer side, any context; returns 0 when the queue is full */
+static inline uint8_t LFQ_MpscPut(LFQ_Mpsc_t *pQ, uint32_t Data) {
+    LFQ_MpscCell_t *pCell;
+    uint32_t head;
+
+    for (;;) {
+        head = pQ->Head;
+        pCell = &pQ->pCells[head & pQ->Mask];
+        LFQ_ACQUIRE();
+        int32_t diff = (int32_t)(pCell->Seq - head);
+        if (diff < 0) {
+            return 0;   /* Slot not yet consumed from the previous lap */
+        }
+        if (diff == 0 && LFQ_CompareAndSwap(&pQ->Head, head, head + 1U)) {
+            break;
+        }
+        /* Another producer took this slot first (or the claim was interrupted) */
+    }
+
+    pCell->Data = Data;
+    LFQ_RELEASE();
+    pCell->Seq = head + 1U;
+    return 1;
+}
+
+/* Consumer side; returns 0 when empty or the oldest slot is still being filled */
+static inline uint8_t LFQ_MpscGet(LFQ_Mpsc_t *pQ, uint32_t *pData) {
+    uint32_t tail = pQ->Tail;
+    LFQ_MpscCell_t *pCell = &pQ->pCells[tail & pQ->Mask];
+
+    if (pCell->Seq != tail + 1U) {
+        return 0;
+    }
+    LFQ_ACQUIRE();
+    *pData = pCell->Data;
+    LFQ_RELEASE();
+    pCell->Seq = tail + pQ->Mask + 1U;
+    pQ->Tail = tail + 1U;
+    return 1;
+}
+
+#endif // LFQUEUE_H
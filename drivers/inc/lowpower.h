@@ -0,0 +1,38 @@
+#ifndef LOWPOWER_H
+#define LOWPOWER_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Idle periods at least this long use STOP mode when an RTC rate was given
+ * to LP_Init; shorter ones use WFI with the SysTick tick suppressed.
+ */
+#ifndef LP_STOP_MIN_MS
+#define LP_STOP_MIN_MS          100U
+#endif
+
+#define LP_STOP_MAX_MS          0x00FFFFFFU     /*!< Longest single STOP (~4.6 h), keeps the RTC scaling in 32 bits */
+#define LP_IDLE_FOREVER         0xFFFFFFFFU     /*!< LP_Idle bound: only the software timers */
+
+/*
+ * Sleep accounting since LP_Init / LP_ResetStats
+ */
+typedef struct {
+    uint64_t SleepUs;       /*!< WFI with the tick suppressed */
+    uint64_t StopUs;        /*!< STOP mode, woken by the RTC alarm or an EXTI line */
+    uint64_t ActiveUs;      /*!< Everything else */
+    uint32_t SleepCount;
+    uint32_t StopCount;
+} LP_Stats_t;
+
+/*
+ * Function Prototypes
+ */
+void LP_Init(uint32_t RtcTickHz);
+void LP_Idle(uint32_t MaxMs);
+void LP_Sleep(uint32_t IdleMs);
+void LP_Stop(uint32_t IdleMs);
+void LP_GetStats(LP_Stats_t *pStats);
+void LP_ResetStats(void);
+
+#endif // LOWPOWER_H
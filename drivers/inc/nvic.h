@@ -0,0 +1,88 @@
+#ifndef NVIC_H
+#define NVIC_H
+
+#include "stm32f1xx.h"
+
+/*
+ * @ref NVIC_Priority_Group
+ * Number of the 4 priority bits used for preemption; the rest is sub-priority
+ */
+#define NVIC_PRIORITYGROUP_0        7U  /*!< 0 preemption bits, 4 sub-priority bits */
+#define NVIC_PRIORITYGROUP_1        6U  /*!< 1 preemption bit,  3 sub-priority bits */
+#define NVIC_PRIORITYGROUP_2        5U  /*!< 2 preemption bits, 2 sub-priority bits */
+#define NVIC_PRIORITYGROUP_3        4U  /*!< 3 preemption bits, 1 sub-priority bit  */
+#define NVIC_PRIORITYGROUP_4        3U  /*!< 4 preemption bits, 0 sub-priority bits (reset default) */
+
+#define NVIC_PRIORITY_LOWEST        ((1U << NVIC_PRIO_BITS) - 1U)
+
+/*
+ * Ceiling of the driver/kernel critical sections. NVIC_EnterCritical masks
+ * priorities CRITICAL..15 only: interrupts at 0..CRITICAL-1 keep running
+ * (e.g. motor control) but must not call into code that uses these
+ * critical sections (swtimer, kernel, ...).
+ */
+#ifndef NVIC_CRITICAL_PRIORITY
+#define NVIC_CRITICAL_PRIORITY      4U
+#endif
+
+/*
+ * Vector table: 16 core exceptions followed by the device IRQs
+ */
+#define NVIC_VECTOR_COUNT           (16U + IRQ_NO_COUNT)
+
+typedef void (*NVIC_Handler_t)(void);
+
+/*
+ * Function Prototypes
+ */
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
+uint32_t NVIC_GetPriorityGrouping(void);
+uint8_t NVIC_EncodePriority(uint8_t PreemptPriority, uint8_t SubPriority);
+
+void NVIC_EnableIRQ(uint8_t IRQNumber);
+void NVIC_DisableIRQ(uint8_t IRQNumber);
+uint8_t NVIC_IsEnabled(uint8_t IRQNumber);
+void NVIC_SetPending(uint8_t IRQNumber);
+void NVIC_ClearPending(uint8_t IRQNumber);
+uint8_t NVIC_IsPending(uint8_t IRQNumber);
+uint8_t NVIC_IsActive(uint8_t IRQNumber);
+void NVIC_SetPriority(uint8_t IRQNumber, uint8_t Priority);
+uint8_t NVIC_GetPriority(uint8_t IRQNumber);
+
+#ifdef NVIC_RAM_VECTORS
+// Vector table in SRAM (build with -DRAM_VECTORS=ON)
+void NVIC_RelocateVectorTable(void);
+void NVIC_SetVector(uint8_t IRQNumber, NVIC_Handler_t pfnHandler);
+NVIC_Handler_t NVIC_GetVector(uint8_t IRQNumber);
+#endif
+
+/**
+ * @brief  Raises BASEPRI to mask interrupts with priority Priority..15.
+ *         BASEPRI_MAX only ever raises the level, so nesting is safe.
+ * @param  Priority: 1..15; 0 would disable masking altogether
+ * @return Previous BASEPRI, to be passed to NVIC_ExitCritical
+ */
+static inline uint32_t NVIC_RaiseBasepri(uint8_t Priority) {
+    uint32_t basepri;
+    uint32_t level = (uint32_t)Priority << (8U - NVIC_PRIO_BITS);
+
+    __asm volatile ("mrs %0, basepri\n\tmsr basepri_max, %1" : "=&r" (basepri) : "r" (level) : "memory");
+    return basepri;
+}
+
+/**
+ * @brief  Enters a critical section at NVIC_CRITICAL_PRIORITY
+ * @return Previous BASEPRI, to be passed to NVIC_ExitCritical
+ */
+static inline uint32_t NVIC_EnterCritical(void) {
+    return NVIC_RaiseBasepri(NVIC_CRITICAL_PRIORITY);
+}
+
+/**
+ * @brief  Restores the BASEPRI saved by NVIC_EnterCritical/NVIC_RaiseBasepri
+ */
+static inline void NVIC_ExitCritical(uint32_t basepri) {
+    __asm volatile ("msr basepri, %0" :: "r" (basepri) : "memory");
+}
+
+#endif // NVIC_H
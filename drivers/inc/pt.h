@@ -0,0 +1,85 @@
+#ifndef PT_H
+#define PT_H
+
+#include "stm32f1xx.h"
+#include "systick.h"
+
+/*
+ * Stackless coroutines (protothreads).
+ *
+ * A coroutine is a function returning char, written between PT_BEGIN and
+ * PT_END, that is called repeatedly from the super-loop. At each wait or
+ * yield it returns to the caller and resumes at the same point on the next
+ * call. Its only state is a pt_t (2 bytes) plus whatever the caller keeps
+ * in its own struct: local variables are NOT preserved across a wait, and
+ * switch statements must not span a wait (the resume point is a case label).
+ *
+ *     static char blink(pt_t *pt, timeout_t *t) {
+ *         PT_BEGIN(pt);
+ *         while (1) {
+ *             GPIO_ToggleOutputPin(GPIOC, GPIO_PIN_13);
+ *             PT_SLEEP(pt, t, 500);
+ *         }
+ *         PT_END(pt);
+ *     }
+ */
+typedef struct {
+    uint16_t lc;                /*!< Resume point (source line), 0 = start */
+} pt_t;
+
+/*
+ * Coroutine return values
+ */
+#define PT_WAITING              0   /*!< Blocked on a condition */
+#define PT_YIELDED              1   /*!< Gave up the CPU voluntarily */
+#define PT_EXITED               2   /*!< Stopped with PT_EXIT */
+#define PT_ENDED                3   /*!< Reached PT_END */
+
+#define PT_INIT(pt)             ((pt)->lc = 0)
+
+#define PT_BEGIN(pt) \
+    { char pt_yield_flag = 1; (void)pt_yield_flag; \
+      switch ((pt)->lc) { case 0:
+
+#define PT_END(pt) \
+      } pt_yield_flag = 0; PT_INIT(pt); return PT_ENDED; }
+
+/* Suspends until cond is true (cond is re-evaluated on every call) */
+#define PT_WAIT_UNTIL(pt, cond) \
+    do { (pt)->lc = __LINE__; __attribute__((fallthrough)); case __LINE__: \
+         if (!(cond)) return PT_WAITING; } while (0)
+
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL((pt), !(cond))
+
+/* Suspends until cond is true or the timeout expires; check cond afterwards */
+#define PT_WAIT_TIMEOUT(pt, cond, pTimeout, ms) \
+    do { timeout_start((pTimeout), (ms)); \
+         PT_WAIT_UNTIL((pt), (cond) || timeout_expired(pTimeout)); } while (0)
+
+/* Suspends for ms milliseconds */
+#define PT_SLEEP(pt, pTimeout, ms) \
+    do { timeout_start((pTimeout), (ms)); \
+         PT_WAIT_UNTIL((pt), timeout_expired(pTimeout)); } while (0)
+
+/* Returns once so other coroutines in the loop get a turn */
+#define PT_YIELD(pt) \
+    do { pt_yield_flag = 0; (pt)->lc = __LINE__; __attribute__((fallthrough)); case __LINE__: \
+         if (pt_yield_flag == 0) return PT_YIELDED; } while (0)
+
+/* Ends the coroutine early; the next call starts from the top */
+#define PT_EXIT(pt) \
+    do { PT_INIT(pt); return PT_EXITED; } while (0)
+
+#define PT_RESTART(pt) \
+    do { PT_INIT(pt); return PT_WAITING; } while (0)
+
+/* Non-zero while a coroutine call has not finished */
+#define PT_SCHEDULE(f)          ((f) < PT_EXITED)
+
+/* Runs a child coroutine to completion from inside a parent */
+#define PT_WAIT_THREAD(pt, thread) PT_WAIT_WHILE((pt), PT_SCHEDULE(thread))
+
+#define PT_SPAWN(pt, child, thread) \
+    do { PT_INIT(child); PT_WAIT_THREAD((pt), (thread)); } while (0)
+
+#endif // PT_H
@@ -3,14 +3,91 @@
 
 #include "stm32f1xx.h"
 
+/*
+ * Oscillator frequencies
+ */
+#ifndef HSE_VALUE
+#define HSE_VALUE                8000000U   /*!< Blue Pill crystal */
+#endif
+#define HSI_VALUE                8000000U
+
+/*
+ * Bus and kernel clock frequencies in Hz, decoded from RCC->CFGR
+ */
+typedef struct {
+    uint32_t SYSCLK_Frequency;
+    uint32_t HCLK_Frequency;       /*!< AHB, core and SysTick */
+    uint32_t PCLK1_Frequency;      /*!< APB1: USART2/3, I2C, SPI2 */
+    uint32_t PCLK2_Frequency;      /*!< APB2: USART1, SPI1, GPIO */
+    uint32_t ADCCLK_Frequency;
+    uint32_t TIMCLK1_Frequency;    /*!< TIM2..TIM4 (x2 when APB1 is divided) */
+    uint32_t TIMCLK2_Frequency;    /*!< TIM1 (x2 when APB2 is divided) */
+} RCC_Clocks_t;
+
+/*
+ * Clock change notification, see RCC_RegisterClockNotifier
+ */
+typedef struct RCC_ClockNotifier {
+    void (*pfnNotify)(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext);
+                                       /*!< Event is a value of @ref RCC_Clock_Events; pClocks
+                                            holds the frequencies in effect when it is called */
+    void *pContext;                    /*!< Passed back unchanged, usually the driver handle */
+    struct RCC_ClockNotifier *pNext;   /*!< Managed by the RCC driver */
+} RCC_ClockNotifier_t;
+
+/*
+ * @ref RCC_Clock_Events
+ */
+#define RCC_CLOCK_EVENT_PRE_CHANGE   0  /*!< Old clocks still running: quiesce the peripheral */
+#define RCC_CLOCK_EVENT_POST_CHANGE  1  /*!< New clocks running: recompute dividers and resume */
+
+/*
+ * @ref RCC_Clock_Profiles
+ */
+#define RCC_CLOCK_HSI_8MHZ       0  /*!< HSI, PLL and HSE off, 0 wait states */
+#define RCC_CLOCK_PLL_24MHZ      1  /*!< HSE x3, 0 wait states */
+#define RCC_CLOCK_PLL_48MHZ      2  /*!< HSE x6, 1 wait state, APB1 = HCLK/2 */
+#define RCC_CLOCK_PLL_72MHZ      3  /*!< HSE x9, 2 wait states, APB1 = HCLK/2 */
+
+/*
+ * RCC Status
+ */
+typedef enum
+{
+  RCC_OK = 0,
+  RCC_ERROR_HSE,      /*!< HSE did not start, running from HSI */
+  RCC_ERROR_PLL       /*!< PLL did not lock, running from HSI */
+} RCC_Status;
+
+/*
+ * @ref RCC_ADC_clock_source (ADCPRE)
+ */
+#define RCC_PCLK2_Div2           (0U << RCC_CFGR_ADCPRE_Pos)
+#define RCC_PCLK2_Div4           (1U << RCC_CFGR_ADCPRE_Pos)
+#define RCC_PCLK2_Div6           (2U << RCC_CFGR_ADCPRE_Pos)
+#define RCC_PCLK2_Div8           (3U << RCC_CFGR_ADCPRE_Pos)
+
 /*
  * =================================================================================
  * Function Prototypes for RCC Driver
  * =================================================================================
  */
 
+void SystemInit(void);
 void SystemClock_Config(void);
 
+// Clock Tree Query
+void RCC_GetClocksFreq(RCC_Clocks_t *RCC_Clocks);
+void RCC_UpdateClocksFreq(void);
+void RCC_ADCCLKConfig(uint32_t RCC_PCLK2);
+
+// Dynamic Frequency Scaling
+RCC_Status RCC_ClockSwitch(uint8_t Profile);
+uint32_t RCC_GetLastSwitchCycles(void);
+uint8_t RCC_GetClockProfile(void);
+void RCC_RegisterClockNotifier(RCC_ClockNotifier_t *pNotifier);
+void RCC_UnregisterClockNotifier(RCC_ClockNotifier_t *pNotifier);
+
 // Peripheral Clock Control
 void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, uint8_t NewState);
 void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, uint8_t NewState);
@@ -2,6 +2,7 @@
 #define SPI_H
 
 #include "stm32f1xx.h"
+#include "dma.h"
 
 /*
  * SPI Configuration Structure
@@ -91,6 +92,53 @@ typedef struct
 #define SPI_SR_TXE                          ((uint16_t)0x0002)
 #define SPI_SR_BSY                          ((uint16_t)0x0080)
 
+/*
+ * SPI CR1/CR2 bits used by the DMA transactions and the bus arbiter
+ */
+#define SPI_CR1_SPE                         ((uint16_t)0x0040)
+#define SPI_CR1_DFF                         ((uint16_t)0x0800)
+#define SPI_CR2_RXDMAEN                     ((uint16_t)0x0001)
+#define SPI_CR2_TXDMAEN                     ((uint16_t)0x0002)
+
+typedef enum
+{
+  SPI_OK = 0,
+  SPI_BUSY,
+  SPI_ERROR
+} SPI_Status;
+
+struct SPI_Transfer;
+typedef void (*SPI_TransferCallback_t)(struct SPI_Transfer *pXfer, void *pContext);
+
+/*
+ * Full-duplex DMA transaction, owned by the caller until pfnDone has run.
+ * Items are bytes, or half-words with SPI_DataSize_16b.
+ */
+typedef struct SPI_Transfer {
+    const void *pTxBuffer;              /*!< Data to send, or 0 to clock out SPI_DUMMY_WORD */
+    void *pRxBuffer;                    /*!< Received data, or 0 to discard it */
+    uint16_t Len;                       /*!< Items, not 0 */
+    GPIO_RegDef_t *pCSPort;             /*!< Chip select port, or 0 when the caller drives it */
+    uint8_t CSPin;                      /*!< Chip select pin, active low */
+    SPI_TransferCallback_t pfnDone;     /*!< Runs in the RX DMA interrupt, may be 0 */
+    void *pContext;
+    volatile SPI_Status Status;         /*!< SPI_BUSY while running, then SPI_OK or SPI_ERROR */
+} SPI_Transfer_t;
+
+#define SPI_DUMMY_WORD                      0xFFFFU
+
+/*
+ * Handle for the DMA transactions of one SPI
+ */
+typedef struct {
+    SPI_TypeDef *pSPIx;
+    uint8_t TxChannel;                  /*!< DMA1 channels claimed by SPI_DMA_Init */
+    uint8_t RxChannel;
+    SPI_Transfer_t *volatile pActive;   /*!< Transaction in flight, 0 when idle */
+    uint16_t TxDummy;                   /*!< Source of the clocked-out dummy items */
+    uint16_t RxDummy;                   /*!< Sink of the discarded items */
+} SPI_Handle_t;
+
 /*
  * Function Prototypes
  */
@@ -98,5 +146,12 @@ void SPI_Init(SPI_TypeDef* SPIx, SPI_Config_t* SPI_InitStruct);
 void SPI_Cmd(SPI_TypeDef* SPIx, uint8_t NewState);
 void SPI_SendData(SPI_TypeDef* SPIx, uint16_t Data);
 uint16_t SPI_ReceiveData(SPI_TypeDef* SPIx);
+uint8_t SPI_GetFlagStatus(SPI_TypeDef* SPIx, uint16_t SPI_FLAG);
+
+// DMA transactions; the DMA channel IRQs must not preempt NVIC_CRITICAL_PRIORITY
+SPI_Status SPI_DMA_Init(SPI_Handle_t *pSPIHandle, SPI_TypeDef *SPIx);
+void SPI_DMA_DeInit(SPI_Handle_t *pSPIHandle);
+SPI_Status SPI_TransferDMA(SPI_Handle_t *pSPIHandle, SPI_Transfer_t *pXfer);
+uint8_t SPI_IsBusy(const SPI_Handle_t *pSPIHandle);
 
 #endif // SPI_H
@@ -0,0 +1,76 @@
+#ifndef SPIBUS_H
+#define SPIBUS_H
+
+#include "stm32f1xx.h"
+#include "spi.h"
+
+/*
+ * Arbiter for several devices on one SPI bus. Each device's CR1 (mode,
+ * clock polarity/phase, prescaler, frame size) is computed once by
+ * SPIBUS_DeviceInit; switching devices is then a plain store of that word
+ * instead of the read-modify-write of SPI_Init. Transactions from all
+ * clients are queued by device priority (0 first, FIFO among equals) and
+ * run back to back on the DMA engine of spi.c. The CR1 store is skipped
+ * when consecutive transactions are for the same device.
+ * The SPI DMA interrupts run the queue (SPIBUS_Done), so they must not
+ * preempt NVIC_CRITICAL_PRIORITY, the level of the queue lock.
+ */
+typedef enum
+{
+  SPIBUS_OK = 0,        /*!< Queued */
+  SPIBUS_DONE,          /*!< Completed */
+  SPIBUS_BUSY,          /*!< Request still queued or running, or DMA channels taken */
+  SPIBUS_ERROR          /*!< Invalid argument, or a DMA transfer error */
+} SPIBUS_Status;
+
+/*
+ * One device (client) on the bus
+ */
+typedef struct {
+    uint16_t Cr1;                   /*!< Precomputed CR1, SPE included */
+    uint8_t Priority;               /*!< 0 is the most urgent */
+    uint8_t CSPin;                  /*!< Chip select pin, active low */
+    GPIO_RegDef_t *pCSPort;         /*!< Chip select port */
+} SPIBUS_Device_t;
+
+struct SPIBUS_Request;
+typedef void (*SPIBUS_Callback_t)(struct SPIBUS_Request *pReq, void *pContext);
+
+/*
+ * Transaction, owned by the caller until its callback has run.
+ * The buffers must stay valid for as long.
+ */
+typedef struct SPIBUS_Request {
+    struct SPIBUS_Request *pNext;
+    const SPIBUS_Device_t *pDevice;
+    SPI_Transfer_t Xfer;            /*!< Buffers and chip select handed to spi.c */
+    SPIBUS_Callback_t pfnDone;      /*!< Runs in the SPI RX DMA interrupt, may be 0 */
+    void *pContext;
+    volatile uint8_t Busy;
+    volatile SPIBUS_Status Status;  /*!< SPIBUS_DONE or SPIBUS_ERROR once finished */
+} SPIBUS_Request_t;
+
+/*
+ * Bus state
+ */
+typedef struct {
+    SPI_Handle_t Spi;
+    SPIBUS_Request_t *pQueue;               /*!< Pending, in priority order */
+    SPIBUS_Request_t *volatile pActive;     /*!< Request on the bus, 0 when idle */
+    const SPIBUS_Device_t *pCurrent;        /*!< Device whose CR1 is loaded */
+    volatile uint32_t Switches;             /*!< CR1 reloads so far */
+} SPIBUS_t;
+
+/*
+ * APIs
+ */
+SPIBUS_Status SPIBUS_Init(SPIBUS_t *pBus, SPI_TypeDef *SPIx);
+void SPIBUS_DeInit(SPIBUS_t *pBus);
+void SPIBUS_DeviceInit(SPIBUS_Device_t *pDevice, const SPI_Config_t *pConfig,
+                       GPIO_RegDef_t *pCSPort, uint8_t CSPin, uint8_t Priority);
+SPIBUS_Status SPIBUS_TransferAsync(SPIBUS_t *pBus, SPIBUS_Request_t *pReq, const SPIBUS_Device_t *pDevice,
+                                   const void *pTxBuffer, void *pRxBuffer, uint16_t Len,
+                                   SPIBUS_Callback_t pfnDone, void *pContext);
+uint8_t SPIBUS_IsBusy(const SPIBUS_Request_t *pReq);
+
+#endif // SPIBUS_H
@@ -317,6 +317,53 @@ typedef struct
   volatile uint32_t CALIB;                  /*!< Offset: 0x00C (R/ )  SysTick Calibration Register */
 } SysTick_Type;
 
+/* SCB (System Control Block) Structure */
+#define SCB_BASE            (SCS_BASE +  0x0D00UL)
+
+typedef struct
+{
+  volatile uint32_t CPUID;                  /*!< Offset: 0x000 (R/ )  CPUID Base Register */
+  volatile uint32_t ICSR;                   /*!< Offset: 0x004 (R/W)  Interrupt Control and State Register */
+  volatile uint32_t VTOR;                   /*!< Offset: 0x008 (R/W)  Vector Table Offset Register */
+  volatile uint32_t AIRCR;                  /*!< Offset: 0x00C (R/W)  Application Interrupt and Reset Control Register */
+  volatile uint32_t SCR;                    /*!< Offset: 0x010 (R/W)  System Control Register */
+  volatile uint32_t CCR;                    /*!< Offset: 0x014 (R/W)  Configuration Control Register */
+  volatile uint8_t  SHP[12U];               /*!< Offset: 0x018 (R/W)  System Handlers Priority Registers (4-7, 8-11, 12-15) */
+  volatile uint32_t SHCSR;                  /*!< Offset: 0x024 (R/W)  System Handler Control and State Register */
+  volatile uint32_t CFSR;                   /*!< Offset: 0x028 (R/W)  Configurable Fault Status Register */
+  volatile uint32_t HFSR;                   /*!< Offset: 0x02C (R/W)  HardFault Status Register */
+  volatile uint32_t DFSR;                   /*!< Offset: 0x030 (R/W)  Debug Fault Status Register */
+  volatile uint32_t MMFAR;                  /*!< Offset: 0x034 (R/W)  MemManage Fault Address Register */
+  volatile uint32_t BFAR;                   /*!< Offset: 0x038 (R/W)  BusFault Address Register */
+  volatile uint32_t AFSR;                   /*!< Offset: 0x03C (R/W)  Auxiliary Fault Status Register */
+} SCB_Type;
+
+/* DWT (Data Watchpoint and Trace) Structure */
+#define DWT_BASE            (0xE0001000UL)
+
+typedef struct
+{
+  volatile uint32_t CTRL;                   /*!< Offset: 0x000 (R/W)  Control Register */
+  volatile uint32_t CYCCNT;                 /*!< Offset: 0x004 (R/W)  Cycle Count Register */
+  volatile uint32_t CPICNT;                 /*!< Offset: 0x008 (R/W)  CPI Count Register */
+  volatile uint32_t EXCCNT;                 /*!< Offset: 0x00C (R/W)  Exception Overhead Count Register */
+  volatile uint32_t SLEEPCNT;               /*!< Offset: 0x010 (R/W)  Sleep Count Register */
+  volatile uint32_t LSUCNT;                 /*!< Offset: 0x014 (R/W)  LSU Count Register */
+  volatile uint32_t FOLDCNT;                /*!< Offset: 0x018 (R/W)  Folded-instruction Count Register */
+  volatile uint32_t PCSR;                   /*!< Offset: 0x01C (R/ )  Program Counter Sample Register */
+} DWT_Type;
+
+/* CoreDebug Structure */
+#define COREDEBUG_BASE      (0xE000EDF0UL)
+
+typedef struct
+{
+  volatile uint32_t DHCSR;                  /*!< Offset: 0x000 (R/W)  Debug Halting Control and Status Register */
+  volatile uint32_t DCRSR;                  /*!< Offset: 0x004 ( /W)  Debug Core Register Selector Register */
+  volatile uint32_t DCRDR;                  /*!< Offset: 0x008 (R/W)  Debug Core Register Data Register */
+  volatile uint32_t DEMCR;                  /*!< Offset: 0x00C (R/W)  Debug Exception and Monitor Control Register */
+} CoreDebug_Type;
+
 /*
  * =================================================================================
  * Peripheral definitions
@@ -355,6 +402,78 @@ typedef struct
 #define DMA2     ((DMA_TypeDef *) DMA2_BASE)
 #define NVIC     ((NVIC_Type      *)     NVIC_BASE     )
 #define SysTick  ((SysTick_Type   *)     SYSTICK_BASE  )
+#define SCB      ((SCB_Type       *)     SCB_BASE      )
+#define DWT      ((DWT_Type       *)     DWT_BASE      )
+#define CoreDebug ((CoreDebug_Type *)    COREDEBUG_BASE)
+
+/*
+ * =================================================================================
+ * IRQ Numbers (IRQ 43..59 exist on high-density/XL STM32F103 only)
+ * =================================================================================
+ */
+#define NVIC_PRIO_BITS          4U   /*!< Implemented priority bits (upper nibble of IP) */
+
+#define IRQ_NO_WWDG             0
+#define IRQ_NO_PVD              1
+#define IRQ_NO_TAMPER           2
+#define IRQ_NO_RTC              3
+#define IRQ_NO_FLASH            4
+#define IRQ_NO_RCC              5
+#define IRQ_NO_EXTI0            6
+#define IRQ_NO_EXTI1            7
+#define IRQ_NO_EXTI2            8
+#define IRQ_NO_EXTI3            9
+#define IRQ_NO_EXTI4            10
+#define IRQ_NO_DMA1_CHANNEL1    11
+#define IRQ_NO_DMA1_CHANNEL2    12
+#define IRQ_NO_DMA1_CHANNEL3    13
+#define IRQ_NO_DMA1_CHANNEL4    14
+#define IRQ_NO_DMA1_CHANNEL5    15
+#define IRQ_NO_DMA1_CHANNEL6    16
+#define IRQ_NO_DMA1_CHANNEL7    17
+#define IRQ_NO_ADC1_2           18
+#define IRQ_NO_USB_HP_CAN_TX    19
+#define IRQ_NO_USB_LP_CAN_RX0   20
+#define IRQ_NO_CAN_RX1          21
+#define IRQ_NO_CAN_SCE          22
+#define IRQ_NO_EXTI9_5          23
+#define IRQ_NO_TIM1_BRK         24
+#define IRQ_NO_TIM1_UP          25
+#define IRQ_NO_TIM1_TRG_COM     26
+#define IRQ_NO_TIM1_CC          27
+#define IRQ_NO_TIM2             28
+#define IRQ_NO_TIM3             29
+#define IRQ_NO_TIM4             30
+#define IRQ_NO_I2C1_EV          31
+#define IRQ_NO_I2C1_ER          32
+#define IRQ_NO_I2C2_EV          33
+#define IRQ_NO_I2C2_ER          34
+#define IRQ_NO_SPI1             35
+#define IRQ_NO_SPI2             36
+#define IRQ_NO_USART1           37
+#define IRQ_NO_USART2           38
+#define IRQ_NO_USART3           39
+#define IRQ_NO_EXTI15_10        40
+#define IRQ_NO_RTC_ALARM        41
+#define IRQ_NO_USB_WAKEUP       42
+#define IRQ_NO_TIM8_BRK         43
+#define IRQ_NO_TIM8_UP          44
+#define IRQ_NO_TIM8_TRG_COM     45
+#define IRQ_NO_TIM8_CC          46
+#define IRQ_NO_ADC3             47
+#define IRQ_NO_FSMC             48
+#define IRQ_NO_SDIO             49
+#define IRQ_NO_TIM5             50
+#define IRQ_NO_SPI3             51
+#define IRQ_NO_UART4            52
+#define IRQ_NO_UART5            53
+#define IRQ_NO_TIM6             54
+#define IRQ_NO_TIM7             55
+#define IRQ_NO_DMA2_CHANNEL1    56
+#define IRQ_NO_DMA2_CHANNEL2    57
+#define IRQ_NO_DMA2_CHANNEL3    58
+#define IRQ_NO_DMA2_CHANNEL4_5  59
+#define IRQ_NO_COUNT            60
 
 /*
  * =================================================================================
@@ -389,12 +508,56 @@ typedef struct
 #define RCC_CFGR_PLLXTPRE   (1 << 17)
 #define RCC_CFGR_PLLMULL9   (7 << 18)
 
+#define RCC_CFGR_SW_Msk     (0x3 << 0)
+#define RCC_CFGR_SWS_Msk    (0x3 << 2)
+#define RCC_CFGR_HPRE_Msk   (0xF << 4)
+#define RCC_CFGR_PPRE1_Msk  (0x7 << 8)
+#define RCC_CFGR_PPRE2_Msk  (0x7 << 11)
+#define RCC_CFGR_ADCPRE_Msk (0x3 << 14)
+#define RCC_CFGR_PLLMULL_Msk (0xF << 18)
+#define RCC_CFGR_HPRE_Pos   4U
+#define RCC_CFGR_PPRE1_Pos  8U
+#define RCC_CFGR_PPRE2_Pos  11U
+#define RCC_CFGR_ADCPRE_Pos 14U
+#define RCC_CFGR_PLLMULL_Pos 18U
+
 /* FLASH_ACR Bit Definitions */
 #define FLASH_ACR_LATENCY_0 (0 << 0)
 #define FLASH_ACR_LATENCY_1 (1 << 0)
 #define FLASH_ACR_LATENCY_2 (2 << 0)
 #define FLASH_ACR_PRFTBE    (1 << 4)
 
+/* FLASH_ACR Mask */
+#define FLASH_ACR_LATENCY_Msk (0x7 << 0)
+
+/* DWT / CoreDebug Bit Definitions */
+#define DWT_CTRL_CYCCNTENA  (1UL << 0)
+#define COREDEBUG_DEMCR_TRCENA (1UL << 24)
+
+/* SCB Bit Definitions */
+#define SCB_ICSR_PENDSTCLR  (1UL << 25)
+#define SCB_ICSR_PENDSTSET  (1UL << 26)
+#define SCB_ICSR_PENDSVSET  (1UL << 28)
+#define SCB_SCR_SLEEPDEEP   (1UL << 2)
+#define SCB_SCR_SEVONPEND   (1UL << 4)
+#define SCB_AIRCR_VECTKEY   (0x05FAUL << 16)
+#define SCB_AIRCR_PRIGROUP_Pos 8
+#define SCB_AIRCR_PRIGROUP_Msk (7UL << SCB_AIRCR_PRIGROUP_Pos)
+
+/* PWR Bit Definitions */
+#define PWR_CR_LPDS         (1 << 0)
+#define PWR_CR_PDDS         (1 << 1)
+#define PWR_CR_CWUF         (1 << 2)
+#define RCC_APB1ENR_PWREN   (1 << 28)
+#define RCC_APB1ENR_BKPEN   (1 << 27)
+
+/* EXTI line 17 is the RTC alarm */
+#define EXTI_LINE_RTC_ALARM (1UL << 17)
+
+/* RCC Bit Defs for DMA */
+#define RCC_AHBENR_DMA1EN   (1 << 0)
+#define RCC_AHBENR_DMA2EN   (1 << 1)
+
 /* RCC Bit Defs for TIM */
 #define RCC_APB2ENR_TIM1EN  (1 << 11)
 #define RCC_APB1ENR_TIM2EN  (1 << 0)
@@ -403,10 +566,18 @@ typedef struct
 #define RCC_APB2ENR_USART1EN (1 << 14)
 #define RCC_APB1ENR_USART2EN (1 << 17)
 #define RCC_APB1ENR_USART3EN (1 << 18)
+#define RCC_APB2ENR_SPI1EN  (1 << 12)
+#define RCC_APB1ENR_SPI2EN  (1 << 14)
 
 /* TIM Bit Defs */
 #define TIM_CR1_CEN         (1 << 0)
+#define TIM_CR1_URS         (1 << 2)
 #define TIM_CR1_DIR         (1 << 4)
+#define TIM_CR1_ARPE        (1 << 7)
+#define TIM_EGR_UG          (1 << 0)
+#define TIM_CR2_MMS_Msk     (0x7 << 4)
+#define TIM_SMCR_SMS_Msk    (0x7 << 0)
+#define TIM_SMCR_TS_Msk     (0x7 << 4)
 #define TIM_DIER_UIE        (1 << 0)
 #define TIM_DIER_CC1IE      (1 << 1)
 #define TIM_DIER_CC2IE      (1 << 2)
@@ -427,14 +598,34 @@ typedef struct
 #define USART_SR_TXE        (1 << 7)
 #define USART_SR_TC         (1 << 6)
 #define USART_SR_RXNE       (1 << 5)
+#define USART_SR_IDLE       (1 << 4)
+#define USART_SR_ORE        (1 << 3)
+#define USART_SR_NE         (1 << 2)
+#define USART_SR_FE         (1 << 1)
+#define USART_SR_PE         (1 << 0)
 #define USART_CR1_UE        (1 << 13)
 #define USART_CR1_M         (1 << 12)
 #define USART_CR1_PCE       (1 << 10)
 #define USART_CR1_PS        (1 << 9)
+#define USART_CR1_PEIE      (1 << 8)
+#define USART_CR1_TXEIE     (1 << 7)
+#define USART_CR1_TCIE      (1 << 6)
+#define USART_CR1_RXNEIE    (1 << 5)
+#define USART_CR1_IDLEIE    (1 << 4)
 #define USART_CR1_TE        (1 << 3)
 #define USART_CR1_RE        (1 << 2)
 #define USART_CR3_CTSE      (1 << 9)
 #define USART_CR3_RTSE      (1 << 8)
+#define USART_CR3_DMAT      (1 << 7)
+#define USART_CR3_DMAR      (1 << 6)
+#define USART_CR3_EIE       (1 << 0)
+#define USART_CR1_TXEIE_Pos 7U
+#define USART_CR1_TCIE_Pos  6U
+
+/* Bit-band alias of a single peripheral register bit (atomic set/clear) */
+#define PERIPH_BB_BASE      0x42000000U
+#define BITBAND_PERIPH(reg, bit) \
+    (*(volatile uint32_t *)(PERIPH_BB_BASE + (((uint32_t)&(reg) - PERIPH_BASE) * 32U) + ((uint32_t)(bit) * 4U)))
 
 /* Generic Macros */
 #define ENABLE              1
@@ -444,4 +635,13 @@ typedef struct
 #define GPIO_PIN_SET        SET
 #define GPIO_PIN_RESET      RESET
 
+/*
+ * Runs the function from SRAM (.ramfunc, copied at reset): no flash wait
+ * states on its fetches. long_call because SRAM is out of BL range of FLASH.
+ */
+#define RAMFUNC             __attribute__((section(".ramfunc"), noinline, long_call))
+
+/* Stops the compiler from moving memory accesses across this point */
+#define COMPILER_BARRIER()  __asm volatile ("" ::: "memory")
+
 #endif // STM32F1XX_H
@@ -0,0 +1,61 @@
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+#include "stm32f1xx.h"
+#include "timer.h"
+
+/*
+ * Wheel geometry: 4 levels of 64 slots, 1 ms tick.
+ * Level k slots are 64^k ticks wide, so the wheel covers 2^24 ms (~4.6 h);
+ * longer timeouts are parked in the last level and re-cascaded.
+ */
+#define SWT_TICK_HZ             1000U
+#define SWT_WHEEL_LEVELS        4U
+#define SWT_WHEEL_BITS          6U
+#define SWT_WHEEL_SLOTS         (1U << SWT_WHEEL_BITS)
+#define SWT_WHEEL_MASK          (SWT_WHEEL_SLOTS - 1U)
+#define SWT_MAX_TIMEOUT         ((1UL << (SWT_WHEEL_LEVELS * SWT_WHEEL_BITS)) - 1U)
+#define SWT_NO_DEADLINE         0xFFFFFFFFU     /*!< SWT_NextDeadline with nothing armed */
+
+/*
+ * Hardware counter rate: 10 counts per tick keeps PSC within 16 bits at
+ * 72MHz and still allows ~6.5 s between wakeups when the wheel is idle.
+ */
+#define SWT_COUNTER_HZ          10000U
+#define SWT_COUNTS_PER_TICK     (SWT_COUNTER_HZ / SWT_TICK_HZ)
+#define SWT_MAX_HW_TICKS        (0x10000U / SWT_COUNTS_PER_TICK)
+
+struct SWT_Timer;
+typedef void (*SWT_Callback_t)(struct SWT_Timer *pTimer, void *pContext);
+
+/*
+ * Timer node, owned by the caller (static or embedded in a protocol
+ * control block). The wheel links it in place and never allocates.
+ */
+typedef struct SWT_Timer {
+    struct SWT_Timer *pNext;
+    struct SWT_Timer **ppPrev;  /*!< Link that points at this node, NULL when idle */
+    uint32_t Expires;           /*!< Absolute tick of the deadline */
+    uint32_t Period;            /*!< Reload in ticks for periodic timers, 0 for one-shot */
+    SWT_Callback_t pfnCallback; /*!< Runs in the timer interrupt */
+    void *pContext;
+    uint8_t Level;
+    uint8_t Slot;
+} SWT_Timer_t;
+
+/*
+ * APIs
+ */
+void SWT_Init(TIM_Handle_t *pTIMHandle);
+void SWT_TimerInit(SWT_Timer_t *pTimer, SWT_Callback_t pfnCallback, void *pContext);
+void SWT_Start(SWT_Timer_t *pTimer, uint32_t Timeout, uint32_t Period);
+void SWT_Stop(SWT_Timer_t *pTimer);
+uint8_t SWT_IsActive(const SWT_Timer_t *pTimer);
+uint32_t SWT_GetTime(void);
+uint32_t SWT_NextDeadline(void);
+void SWT_CatchUp(uint32_t ElapsedMs);
+
+// Vector of the wheel's timer
+void SWT_IRQHandler(void);
+
+#endif // SWTIMER_H
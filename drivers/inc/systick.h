@@ -18,11 +18,38 @@
 #define SYSTICK_CTRL_COUNTFLAG_Pos  16U
 #define SYSTICK_CTRL_COUNTFLAG_Msk  (1UL << SYSTICK_CTRL_COUNTFLAG_Pos)
 
+/*
+ * Tick rate
+ */
+#define SYSTICK_TICK_HZ             1000U
+#define SYSTICK_LOAD_MAX            0x00FFFFFFUL
+
+/*
+ * Non-blocking timeout
+ */
+typedef struct {
+    uint32_t start;     /*!< millis() when armed */
+    uint32_t duration;  /*!< Milliseconds until expiry */
+} timeout_t;
+
 /*
  * Function Prototypes
  */
-void SysTick_Init(uint32_t system_clock_freq);
+void SysTick_Init(void);
+uint32_t millis(void);
+void timeout_start(timeout_t *pTimeout, uint32_t ms);
+void timeout_restart(timeout_t *pTimeout);
+uint8_t timeout_expired(const timeout_t *pTimeout);
+uint32_t timeout_remaining(const timeout_t *pTimeout);
 void delay_ms(uint32_t ms);
 void delay_us(uint32_t us);
 
+// Tickless idle
+uint32_t SysTick_TicklessSleep(uint32_t ms);
+void SysTick_Suspend(void);
+void SysTick_Resume(uint32_t ElapsedMs);
+
+// Application Callback, runs in the SysTick interrupt after millis() advances
+void SysTick_Callback(void);
+
 #endif // SYSTICK_H
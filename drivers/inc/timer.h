@@ -2,6 +2,7 @@
 #define TIMER_H
 
 #include "stm32f1xx.h"
+#include "rcc.h"
 
 /*
  * Configuration structure for Timer
@@ -10,6 +11,9 @@ typedef struct {
     uint16_t Prescaler;       /*!< Specifies the prescaler value used to divide the TIM clock. */
     uint16_t Period;          /*!< Specifies the period value to be loaded into the active Auto-Reload Register at the next update event. */
     uint16_t CounterMode;     /*!< Specifies the counter mode. This parameter can be a value of @ref TIM_Counter_Mode */
+    uint16_t MasterOutputTrigger; /*!< Specifies the TRGO source for timers slaved to this one. This parameter can be a value of @ref TIM_Master_Output_Trigger */
+    uint16_t SlaveMode;       /*!< Specifies how the trigger input drives the counter. This parameter can be a value of @ref TIM_Slave_Mode */
+    uint16_t InputTrigger;    /*!< Specifies the trigger input used in slave mode. This parameter can be a value of @ref TIM_Trigger_Selection */
 } TIM_Base_Config_t;
 
 /*
@@ -39,6 +43,8 @@ typedef struct {
     TIM_Base_Config_t BaseConfig;
     TIM_PWM_Config_t PWMConfig;
     TIM_IC_Config_t ICConfig;
+    uint32_t CounterFreq;                 /*!< CNT rate set by TIM_Base_Init, kept across clock changes */
+    RCC_ClockNotifier_t ClockNotifier;    /*!< Registered by TIM_Base_Init to re-tune PSC */
 } TIM_Handle_t;
 
 /*
@@ -47,6 +53,41 @@ typedef struct {
 #define TIM_COUNTERMODE_UP                0x0000
 #define TIM_COUNTERMODE_DOWN              TIM_CR1_DIR
 
+/*
+ * TIM_Master_Output_Trigger (CR2 MMS)
+ */
+#define TIM_TRGO_RESET                    0x0000
+#define TIM_TRGO_ENABLE                   0x0010
+#define TIM_TRGO_UPDATE                   0x0020
+#define TIM_TRGO_OC1                      0x0030
+#define TIM_TRGO_OC1REF                   0x0040
+#define TIM_TRGO_OC2REF                   0x0050
+#define TIM_TRGO_OC3REF                   0x0060
+#define TIM_TRGO_OC4REF                   0x0070
+
+/*
+ * TIM_Slave_Mode (SMCR SMS)
+ */
+#define TIM_SLAVEMODE_DISABLE             0x0000
+#define TIM_SLAVEMODE_RESET               0x0004 /*!< Trigger edge reinitializes the counter */
+#define TIM_SLAVEMODE_GATED               0x0005 /*!< Counter runs while the trigger is high */
+#define TIM_SLAVEMODE_TRIGGER             0x0006 /*!< Trigger edge starts the counter */
+#define TIM_SLAVEMODE_EXTERNAL1           0x0007 /*!< Trigger edges clock the counter */
+
+/*
+ * TIM_Trigger_Selection (SMCR TS)
+ * Internal triggers on F103: TIM2 ITR0=TIM1 ITR2=TIM3 ITR3=TIM4,
+ * TIM3 ITR0=TIM1 ITR1=TIM2 ITR3=TIM4, TIM4 ITR0=TIM1 ITR1=TIM2 ITR2=TIM3
+ */
+#define TIM_TS_ITR0                       0x0000
+#define TIM_TS_ITR1                       0x0010
+#define TIM_TS_ITR2                       0x0020
+#define TIM_TS_ITR3                       0x0030
+#define TIM_TS_TI1F_ED                    0x0040
+#define TIM_TS_TI1FP1                     0x0050
+#define TIM_TS_TI2FP2                     0x0060
+#define TIM_TS_ETRF                       0x0070
+
 /*
  * TIM_Output_Compare_and_PWM_modes
  */
@@ -96,6 +137,8 @@ void TIM_Base_Start(TIM_TypeDef *TIMx);
 void TIM_Base_Stop(TIM_TypeDef *TIMx);
 void TIM_Base_Start_IT(TIM_TypeDef *TIMx);
 void TIM_Base_Stop_IT(TIM_TypeDef *TIMx);
+uint32_t TIM_GetClockFreq(TIM_TypeDef *TIMx);
+uint16_t TIM_CalcPrescaler(TIM_TypeDef *TIMx, uint32_t CounterFreq);
 
 // PWM
 void TIM_PWM_Init(TIM_Handle_t *pTIMHandle, uint8_t Channel);
@@ -2,6 +2,8 @@
 #define UART_H
 
 #include "stm32f1xx.h"
+#include "dma.h"
+#include "rcc.h"
 
 /*
  * Configuration structure for UART
@@ -20,12 +22,67 @@ typedef struct {
                                    This parameter can be a value of @ref UART_Hardware_Flow_Control */
 } UART_Config_t;
 
+/*
+ * Ring buffer sizes for interrupt-driven mode (must be powers of two)
+ */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE                 64U
+#endif
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE                 64U
+#endif
+
+/*
+ * Single-producer/single-consumer byte ring.
+ * Head is only written by the producer and Tail only by the consumer, so the
+ * thread and the ISR never need to mask interrupts to share it.
+ */
+typedef struct {
+    volatile uint16_t Head;   /*!< Free-running write index (producer) */
+    volatile uint16_t Tail;   /*!< Free-running read index (consumer) */
+} UART_RingIndex_t;
+
+/*
+ * One contiguous piece of a DMA transmission (e.g. header, payload, CRC)
+ */
+typedef struct {
+    const uint8_t *pData;     /*!< Start of the segment, must stay valid until UART_EVENT_TX_CMPLT */
+    uint16_t Len;             /*!< Number of bytes, 0 is allowed and skipped */
+} UART_TxSegment_t;
+
+/*
+ * UART Status
+ */
+typedef enum
+{
+  UART_OK = 0,
+  UART_BUSY,
+  UART_ERROR
+} UART_Status;
+
 /*
  * Handle structure for UART
  */
 typedef struct {
     USART_TypeDef *pUSARTx;
     UART_Config_t UART_Config;
+    UART_RingIndex_t TxRing;                  /*!< Producer: UART_Write, consumer: TXE interrupt */
+    UART_RingIndex_t RxRing;                  /*!< Producer: RXNE interrupt, consumer: UART_Read */
+    uint8_t TxBuffer[UART_TX_BUFFER_SIZE];
+    uint8_t RxBuffer[UART_RX_BUFFER_SIZE];
+    volatile uint32_t RxDropped;              /*!< Bytes lost because RxBuffer was full or on overrun */
+    const UART_TxSegment_t *pTxSegments;      /*!< Segment chain of the DMA transmission in flight */
+    uint8_t TxSegmentCount;
+    volatile uint8_t TxSegmentIndex;          /*!< Segment currently owned by the DMA channel */
+    volatile uint8_t TxDMABusy;
+    uint8_t TxDMAChannel;                     /*!< DMA1 channel claimed for TX, DMA_CHANNEL_NONE when idle */
+    uint8_t RxDMAChannel;                     /*!< DMA1 channel claimed for circular RX, DMA_CHANNEL_NONE when stopped */
+    uint8_t *pRxDMABuffer;                    /*!< Circular DMA receive area, NULL when not in DMA RX mode */
+    uint16_t RxDMASize;
+    uint16_t RxDMAReadPos;                    /*!< First byte not yet handed to UART_RxEventCallback */
+    RCC_ClockNotifier_t ClockNotifier;        /*!< Registered by UART_Init to re-tune BRR on clock changes */
+    uint32_t ClockSuspendedTx;                /*!< TX feed bits paused across a clock switch */
 } UART_Handle_t;
 
 /*
@@ -64,6 +121,15 @@ typedef struct {
 #define UART_HW_FLOW_CTRL_RTS               USART_CR3_RTSE
 #define UART_HW_FLOW_CTRL_CTS_RTS           (USART_CR3_CTSE | USART_CR3_RTSE)
 
+/*
+ * @ref UART_Application_Events
+ */
+#define UART_EVENT_TX_CMPLT                 0   /*!< Last queued byte has left the shift register */
+#define UART_EVENT_RX_FULL                  1   /*!< Received byte dropped, RxBuffer full */
+#define UART_EVENT_ORE                      2   /*!< Hardware overrun, at least one byte lost */
+#define UART_EVENT_DMA_TX_ERROR             3   /*!< DMA transfer error, transmission aborted */
+#define UART_EVENT_DMA_RX_ERROR             4   /*!< DMA transfer error, circular reception stopped */
+
 /*
  * APIs
  */
@@ -77,6 +143,19 @@ void UART_Transmit(UART_Handle_t *pUARTHandle, uint8_t *pTxBuffer, uint32_t Len)
 void UART_Receive(UART_Handle_t *pUARTHandle, uint8_t *pRxBuffer, uint32_t Len);
 uint8_t UART_ReceiveByte(UART_Handle_t *pUARTHandle);
 
+// Interrupt-driven (non-blocking) Data Transfer
+void UART_EnableIT(UART_Handle_t *pUARTHandle);
+void UART_DisableIT(UART_Handle_t *pUARTHandle);
+uint32_t UART_Write(UART_Handle_t *pUARTHandle, const uint8_t *pTxBuffer, uint32_t Len);
+uint32_t UART_Read(UART_Handle_t *pUARTHandle, uint8_t *pRxBuffer, uint32_t Len);
+uint32_t UART_TxFree(UART_Handle_t *pUARTHandle);
+uint32_t UART_RxAvailable(UART_Handle_t *pUARTHandle);
+
+// DMA Data Transfer
+UART_Status UART_TransmitDMA(UART_Handle_t *pUARTHandle, const UART_TxSegment_t *pSegments, uint8_t NumSegments);
+UART_Status UART_ReceiveToIdleDMA(UART_Handle_t *pUARTHandle, uint8_t *pRxBuffer, uint16_t Size);
+void UART_StopReceiveDMA(UART_Handle_t *pUARTHandle);
+
 // Interrupts
 void UART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi);
 void UART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
@@ -84,5 +163,7 @@ void UART_IRQHandler(UART_Handle_t *pUARTHandle);
 
 // Application Callbacks
 void UART_ApplicationEventCallback(UART_Handle_t *pUARTHandle, uint8_t AppEv);
+void UART_RxEventCallback(UART_Handle_t *pUARTHandle, const uint8_t *pData1, uint16_t Len1,
+                          const uint8_t *pData2, uint16_t Len2);
 
 #endif // UART_H
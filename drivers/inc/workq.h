@@ -0,0 +1,43 @@
+#ifndef WORKQ_H
+#define WORKQ_H
+
+#include "stm32f1xx.h"
+
+/*
+ * Deferred interrupt work (bottom halves).
+ * An ISR acknowledges its hardware, stashes its data and posts a work item;
+ * the item's function then runs from PendSV at the lowest priority, where
+ * any other interrupt can preempt it. Items are drained highest priority
+ * level first and in FIFO order within a level.
+ * Posting is lock-free (LDREX/STREX), so it is allowed from every
+ * interrupt priority, including those above NVIC_CRITICAL_PRIORITY.
+ */
+#define WQ_PRIO_LEVELS          4U      /*!< Priority 0 runs first */
+
+#ifndef WQ_QUEUE_SIZE
+#define WQ_QUEUE_SIZE           16U     /*!< Items per level, power of two */
+#endif
+
+typedef void (*WQ_Function_t)(void *pArg);
+
+/*
+ * Work item, owned by the caller (static). While posted it is queued once:
+ * posting it again before it has run is a no-op.
+ */
+typedef struct {
+    WQ_Function_t pfnWork;
+    void *pArg;
+    volatile uint32_t Pending;      /*!< Set by WQ_Post, cleared just before pfnWork runs */
+    uint8_t Priority;               /*!< 0..WQ_PRIO_LEVELS-1 */
+} WQ_Work_t;
+
+/*
+ * APIs
+ */
+void WQ_Init(void);
+void WQ_WorkInit(WQ_Work_t *pWork, WQ_Function_t pfnWork, void *pArg, uint8_t Priority);
+uint8_t WQ_Post(WQ_Work_t *pWork);
+void WQ_Run(void);
+uint32_t WQ_GetOverflows(void);
+
+#endif // WORKQ_H
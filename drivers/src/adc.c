@@ -1,4 +1,5 @@
 #include "adc.h"
+#include "rcc.h"
 
 /**
  * @brief  Initializes the ADCx peripheral according to the specified parameters
@@ -10,6 +11,20 @@
 void ADC_Init(ADC_TypeDef* ADCx, ADC_Config_t* ADC_InitStruct) {
     uint32_t tmpreg1 = 0;
     uint8_t tmpreg2 = 0;
+    RCC_Clocks_t rcc_clocks;
+
+    /*---------------------------- ADCCLK Configuration -------------------*/
+    /* Pick the smallest PCLK2 divider keeping ADCCLK within its 14 MHz limit */
+    RCC_GetClocksFreq(&rcc_clocks);
+    if (rcc_clocks.PCLK2_Frequency <= 2U * ADC_MAX_CLOCK_FREQ) {
+        RCC_ADCCLKConfig(RCC_PCLK2_Div2);
+    } else if (rcc_clocks.PCLK2_Frequency <= 4U * ADC_MAX_CLOCK_FREQ) {
+        RCC_ADCCLKConfig(RCC_PCLK2_Div4);
+    } else if (rcc_clocks.PCLK2_Frequency <= 6U * ADC_MAX_CLOCK_FREQ) {
+        RCC_ADCCLKConfig(RCC_PCLK2_Div6);
+    } else {
+        RCC_ADCCLKConfig(RCC_PCLK2_Div8);
+    }
 
     /*---------------------------- ADCx CR1 Configuration -----------------*/
     /* Get the ADCx CR1 value */
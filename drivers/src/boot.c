@@ -0,0 +1,19 @@
+#include "boot.h"
+
+/* Filled in by v_v_reset_handler before .data/.bss exist */
+BOOT_Profile_t g_boot_profile __attribute__((section(".noinit")));
+
+/**
+ * @brief  Boot phase timestamps of the current run
+ * @return Profile, or 0 if the reset handler did not record one
+ */
+const BOOT_Profile_t *BOOT_GetProfile(void) {
+    return (g_boot_profile.Magic == BOOT_PROFILE_MAGIC) ? &g_boot_profile : 0;
+}
+
+/**
+ * @brief  Core cycles from reset entry to the call of main (0 if unknown)
+ */
+uint32_t BOOT_GetCyclesToMain(void) {
+    return (g_boot_profile.Magic == BOOT_PROFILE_MAGIC) ? g_boot_profile.MainCycles : 0;
+}
@@ -24,7 +24,7 @@ uint32_t CRC_CalcCRC(uint32_t Data) {
  * @param  BufferLength: length of the buffer to be computed.
  * @return 32-bit CRC.
  */
-uint32_t CRC_CalcBlockCRC(uint32_t pBuffer[], uint32_t BufferLength) {
+RAMFUNC uint32_t CRC_CalcBlockCRC(uint32_t pBuffer[], uint32_t BufferLength) {
     uint32_t index = 0;
     
     for (index = 0; index < BufferLength; index++) {
@@ -1,4 +1,32 @@
 #include "dma.h"
+#include "nvic.h"
+
+/*
+ * Per-channel owner and callbacks of the DMA1 channel manager
+ */
+typedef struct {
+    uint8_t Claimed;
+    DMA_Callback_t pfnHalf;
+    DMA_Callback_t pfnComplete;
+    DMA_Callback_t pfnError;
+    void *pContext;
+} DMA_ChannelState_t;
+
+static DMA_ChannelState_t g_dma_channels[DMA1_CHANNEL_COUNT];
+
+/* DMA1 channel (1..7) of each @ref DMA_Requests, 0 for DMA_REQ_MEM2MEM */
+static const uint8_t DMA_RequestChannel[DMA_REQ_COUNT] = {
+    1,          // ADC1
+    2, 3,       // SPI1 RX, TX
+    4, 5,       // SPI2 RX, TX
+    4, 5,       // USART1 TX, RX
+    7, 6,       // USART2 TX, RX
+    2, 3,       // USART3 TX, RX
+    6, 7,       // I2C1 TX, RX
+    4, 5,       // I2C2 TX, RX
+    5, 2, 3, 7, // TIM1..TIM4 UP
+    0,          // MEM2MEM
+};
 
 /**
  * @brief  Initializes the DMAy Channelx according to the specified parameters 
@@ -15,14 +43,14 @@ void DMA_Init(DMA_Channel_TypeDef* DMAy_Channelx, DMA_Init_t* DMA_InitStruct) {
     /* Get the DMAy_Channelx CCR value */
     tmpreg = DMAy_Channelx->CCR;
 
-    /* Clear MEM2MEM, PL, MSIZE, PSIZE, MINC, PINC, CIRC and DIR bits */
-    tmpreg &= 0xFFFF800F;
+    /* Clear MEM2MEM, PL, MSIZE, PSIZE, MINC, PINC, CIRC, DIR, TEIE, HTIE and TCIE bits */
+    tmpreg &= 0xFFFF8001;
 
-    /* Configure DMAy Channelx: data transfer, data size, priority level and mode */
+    /* Configure DMAy Channelx: data transfer, data size, priority level, mode and interrupts */
     tmpreg |= DMA_InitStruct->DMA_DIR | DMA_InitStruct->DMA_Mode |
               DMA_InitStruct->DMA_PeripheralInc | DMA_InitStruct->DMA_MemoryInc |
               DMA_InitStruct->DMA_PeripheralDataSize | DMA_InitStruct->DMA_MemoryDataSize |
-              DMA_InitStruct->DMA_Priority | DMA_InitStruct->DMA_M2M;
+              DMA_InitStruct->DMA_Priority | DMA_InitStruct->DMA_M2M | DMA_InitStruct->DMA_IT;
 
     /* Write to DMAy Channelx CCR */
     DMAy_Channelx->CCR = tmpreg;
@@ -78,3 +106,210 @@ void DMA_Cmd(DMA_Channel_TypeDef* DMAy_Channelx, uint8_t NewState) {
         DMAy_Channelx->CCR &= (uint16_t)(~1);
     }
 }
+
+/**
+ * @brief  Enables or disables the specified DMAy Channelx interrupts.
+ * @param  DMAy_Channelx: where y can be 1 or 2 to select the DMA and 
+ *         x can be 1 to 7 for DMA1 and 1 to 5 for DMA2 to select the DMA Channel.
+ * @param  DMA_IT: specifies the DMA interrupts sources to be enabled or disabled.
+ *         This parameter can be any combination of @ref DMA_interrupts.
+ * @param  NewState: new state of the specified DMA interrupts.
+ *         This parameter can be: ENABLE or DISABLE.
+ */
+void DMA_ITConfig(DMA_Channel_TypeDef* DMAy_Channelx, uint32_t DMA_IT, uint8_t NewState) {
+    if (NewState != DISABLE) {
+        /* Enable the selected DMA interrupts */
+        DMAy_Channelx->CCR |= DMA_IT;
+    } else {
+        /* Disable the selected DMA interrupts */
+        DMAy_Channelx->CCR &= ~DMA_IT;
+    }
+}
+
+/**
+ * @brief  Checks whether the specified DMAy Channelx flag is set or not.
+ * @param  DMAy: where y can be 1 or 2 to select the DMA.
+ * @param  DMA_FLAG: specifies the flag to check, built with @ref DMA_flags.
+ * @return The new state of DMA_FLAG (SET or RESET).
+ */
+uint8_t DMA_GetFlagStatus(DMA_TypeDef* DMAy, uint32_t DMA_FLAG) {
+    if ((DMAy->ISR & DMA_FLAG) != (uint32_t)RESET) {
+        return SET;
+    } else {
+        return RESET;
+    }
+}
+
+/**
+ * @brief  Clears the DMAy Channelx's pending flags.
+ * @param  DMAy: where y can be 1 or 2 to select the DMA.
+ * @param  DMA_FLAG: specifies the flags to clear, built with @ref DMA_flags.
+ */
+void DMA_ClearFlag(DMA_TypeDef* DMAy, uint32_t DMA_FLAG) {
+    /* IFCR is write-1-to-clear, no read-modify-write needed */
+    DMAy->IFCR = DMA_FLAG;
+}
+
+/**
+ * @brief  DMA1 channel hard-wired to a peripheral request
+ * @param  Request: a value of @ref DMA_Requests
+ * @return Channel 1..7, or DMA_CHANNEL_NONE for DMA_REQ_MEM2MEM or an unknown request
+ */
+uint8_t DMA_GetRequestChannel(uint8_t Request) {
+    return (Request < DMA_REQ_COUNT) ? DMA_RequestChannel[Request] : DMA_CHANNEL_NONE;
+}
+
+/**
+ * @brief  Takes ownership of the DMA1 channel serving a request. Enables
+ *         the DMA1 clock and the channel interrupt in the NVIC at
+ *         DMA_IRQ_PRIORITY; a caller may lower it (numerically raise it)
+ *         with NVIC_SetPriority, but not go above NVIC_CRITICAL_PRIORITY.
+ * @param  Request: a value of @ref DMA_Requests
+ * @return Channel 1..7, or DMA_CHANNEL_NONE if it is already claimed
+ *         (for DMA_REQ_MEM2MEM: if every channel is)
+ */
+uint8_t DMA_Claim(uint8_t Request) {
+    uint8_t channel = DMA_GetRequestChannel(Request);
+    uint32_t basepri;
+
+    if ((channel == DMA_CHANNEL_NONE) && (Request != DMA_REQ_MEM2MEM)) {
+        return DMA_CHANNEL_NONE;
+    }
+
+    basepri = NVIC_EnterCritical();
+    if (Request == DMA_REQ_MEM2MEM) {
+        // Lowest hardware priority first, leaving channel 1.. to the peripherals
+        for (channel = DMA1_CHANNEL_COUNT; channel > 0; channel--) {
+            if (!g_dma_channels[channel - 1U].Claimed) {
+                break;
+            }
+        }
+    } else if (g_dma_channels[channel - 1U].Claimed) {
+        channel = DMA_CHANNEL_NONE;
+    }
+    if (channel != DMA_CHANNEL_NONE) {
+        g_dma_channels[channel - 1U].Claimed = 1;
+    }
+    NVIC_ExitCritical(basepri);
+
+    if (channel != DMA_CHANNEL_NONE) {
+        RCC->AHBENR |= RCC_AHBENR_DMA1EN;
+        DMA_ClearFlag(DMA1, DMA_FLAG_GL(channel));
+        NVIC_ClearPending((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + channel - 1U));
+        NVIC_SetPriority((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + channel - 1U), DMA_IRQ_PRIORITY);
+        NVIC_EnableIRQ((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + channel - 1U));
+    }
+    return channel;
+}
+
+/**
+ * @brief  Stops a claimed channel and gives it back. Its interrupt is
+ *         disabled and its callbacks dropped; callable from its own callbacks.
+ * @param  Channel: 1..7, as returned by DMA_Claim
+ */
+void DMA_Release(uint8_t Channel) {
+    DMA_ChannelState_t *pState;
+
+    if ((Channel == DMA_CHANNEL_NONE) || (Channel > DMA1_CHANNEL_COUNT)) {
+        return;
+    }
+    pState = &g_dma_channels[Channel - 1U];
+
+    NVIC_DisableIRQ((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + Channel - 1U));
+    DMA1->Channel[Channel - 1U].CCR = 0;
+    DMA_ClearFlag(DMA1, DMA_FLAG_GL(Channel));
+
+    pState->pfnHalf = 0;
+    pState->pfnComplete = 0;
+    pState->pfnError = 0;
+    pState->pContext = 0;
+    COMPILER_BARRIER();
+    pState->Claimed = 0;
+}
+
+/**
+ * @brief  Registers the event callbacks of a claimed channel. Each one only
+ *         runs if its interrupt (DMA_IT_HT, DMA_IT_TC, DMA_IT_TE) is enabled
+ *         in the channel's CCR. Set them before enabling the channel.
+ * @param  Channel: 1..7, as returned by DMA_Claim
+ * @param  pfnHalf: half transfer, or 0
+ * @param  pfnComplete: transfer complete, or 0
+ * @param  pfnError: transfer error (the hardware has disabled the channel), or 0
+ * @param  pContext: passed to the callbacks
+ */
+void DMA_SetCallbacks(uint8_t Channel, DMA_Callback_t pfnHalf, DMA_Callback_t pfnComplete,
+                      DMA_Callback_t pfnError, void *pContext) {
+    DMA_ChannelState_t *pState = &g_dma_channels[Channel - 1U];
+
+    pState->pfnHalf = pfnHalf;
+    pState->pfnComplete = pfnComplete;
+    pState->pfnError = pfnError;
+    pState->pContext = pContext;
+}
+
+/**
+ * @brief  Registers of a DMA1 channel
+ * @param  Channel: 1..7
+ */
+DMA_Channel_TypeDef *DMA_GetChannel(uint8_t Channel) {
+    return &DMA1->Channel[Channel - 1U];
+}
+
+/**
+ * @brief  Data items the channel still has to transfer (CNDTR). In circular
+ *         mode it counts down to 0 and reloads, so size - remaining is the
+ *         current write position.
+ * @param  Channel: 1..7
+ */
+uint16_t DMA_GetRemaining(uint8_t Channel) {
+    return (uint16_t)DMA1->Channel[Channel - 1U].CNDTR;
+}
+
+/**
+ * @brief  Clears a channel's flags and dispatches them to its callbacks:
+ *         error alone, otherwise half then complete. Flags whose interrupt
+ *         is disabled are left for polling (DMA_GetFlagStatus).
+ * @param  Channel: 1..7
+ */
+RAMFUNC void DMA_IRQHandling(uint8_t Channel) {
+    DMA_ChannelState_t *pState = &g_dma_channels[Channel - 1U];
+    uint32_t shift = 4U * (Channel - 1U);
+    uint32_t flags = (DMA1->ISR >> shift) & (DMA1->Channel[Channel - 1U].CCR & (DMA_IT_TC | DMA_IT_HT | DMA_IT_TE));
+    DMA_Callback_t pfnCallback;
+
+    // The nibble layout of ISR/IFCR matches the CCR interrupt enables: TC=1, HT=2, TE=3
+    DMA1->IFCR = flags << shift;
+
+    if (flags & DMA_IT_TE) {
+        pfnCallback = pState->pfnError;
+        if (pfnCallback != 0) {
+            pfnCallback(Channel, pState->pContext);
+        }
+        return;
+    }
+
+    // Reloaded after each call: a callback may release the channel
+    if (flags & DMA_IT_HT) {
+        pfnCallback = pState->pfnHalf;
+        if (pfnCallback != 0) {
+            pfnCallback(Channel, pState->pContext);
+        }
+    }
+    if (flags & DMA_IT_TC) {
+        pfnCallback = pState->pfnComplete;
+        if (pfnCallback != 0) {
+            pfnCallback(Channel, pState->pContext);
+        }
+    }
+}
+
+/*
+ * DMA1 channel vectors, owned by the manager
+ */
+void v_v_dma1_channel1_handler(void) { DMA_IRQHandling(1); }
+void v_v_dma1_channel2_handler(void) { DMA_IRQHandling(2); }
+void v_v_dma1_channel3_handler(void) { DMA_IRQHandling(3); }
+void v_v_dma1_channel4_handler(void) { DMA_IRQHandling(4); }
+void v_v_dma1_channel5_handler(void) { DMA_IRQHandling(5); }
+void v_v_dma1_channel6_handler(void) { DMA_IRQHandling(6); }
+void v_v_dma1_channel7_handler(void) { DMA_IRQHandling(7); }
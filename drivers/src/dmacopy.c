@@ -0,0 +1,262 @@
+#include <string.h>
+#include "dmacopy.h"
+#include "dma.h"
+#include "nvic.h"
+
+/*
+ * FIFO of pending requests; the head one owns the channel
+ */
+static DMACPY_Request_t *g_dmacpy_head;
+static DMACPY_Request_t *g_dmacpy_tail;
+static uint8_t g_dmacpy_channel = DMA_CHANNEL_NONE;
+static uint32_t g_dmacpy_threshold = DMACPY_CPU_THRESHOLD;
+
+// Helper to program and start the next chunk of a request
+static void DMACPY_StartChunk(DMACPY_Request_t *pReq) {
+    DMA_Channel_TypeDef *pChannel = DMA_GetChannel(g_dmacpy_channel);
+    uint32_t items = pReq->Len / pReq->Width;
+    DMA_Init_t dmaInit;
+
+    if (items > DMACPY_MAX_ITEMS) {
+        items = DMACPY_MAX_ITEMS;
+    }
+    pReq->Chunk = items * pReq->Width;
+
+    // M2M: the "peripheral" side is the source
+    dmaInit.DMA_PeripheralBaseAddr = (uint32_t)pReq->pSrc;
+    dmaInit.DMA_MemoryBaseAddr = (uint32_t)pReq->pDst;
+    dmaInit.DMA_DIR = DMA_DIR_PeripheralSRC;
+    dmaInit.DMA_BufferSize = items;
+    dmaInit.DMA_PeripheralInc = pReq->IsFill ? DMA_PeripheralInc_Disable : DMA_PeripheralInc_Enable;
+    dmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInit.DMA_PeripheralDataSize = (pReq->Width == 4U) ? DMA_PeripheralDataSize_Word :
+                                     (pReq->Width == 2U) ? DMA_PeripheralDataSize_HalfWord :
+                                                           DMA_PeripheralDataSize_Byte;
+    dmaInit.DMA_MemoryDataSize = (pReq->Width == 4U) ? DMA_MemoryDataSize_Word :
+                                 (pReq->Width == 2U) ? DMA_MemoryDataSize_HalfWord :
+                                                       DMA_MemoryDataSize_Byte;
+    dmaInit.DMA_Mode = DMA_Mode_Normal;
+    dmaInit.DMA_Priority = DMA_Priority_Low;    // Peripheral requests go first
+    dmaInit.DMA_M2M = DMA_M2M_Enable;
+    dmaInit.DMA_IT = DMA_IT_TC | DMA_IT_TE;
+
+    // CNDTR/CPAR/CMAR are only writable while the channel is disabled
+    DMA_Cmd(pChannel, DISABLE);
+    DMA_Init(pChannel, &dmaInit);
+    DMA_Cmd(pChannel, ENABLE);
+}
+
+// Helper to take the finished head off the queue, start the next one and report the old one
+static void DMACPY_Finish(DMACPY_Status Status) {
+    DMACPY_Request_t *pReq = g_dmacpy_head;
+
+    g_dmacpy_head = pReq->pNext;
+    if (g_dmacpy_head == 0) {
+        g_dmacpy_tail = 0;
+    } else {
+        DMACPY_StartChunk(g_dmacpy_head);
+    }
+
+    pReq->Status = Status;
+    pReq->Busy = 0;
+    if (pReq->pfnDone != 0) {
+        pReq->pfnDone(pReq, pReq->pContext);
+    }
+}
+
+// Channel transfer complete: next chunk of the same request, or the next request
+static void DMACPY_Complete(uint8_t Channel, void *pContext) {
+    DMACPY_Request_t *pReq = g_dmacpy_head;
+    (void)Channel;
+    (void)pContext;
+
+    pReq->pDst += pReq->Chunk;
+    if (!pReq->IsFill) {
+        pReq->pSrc += pReq->Chunk;
+    }
+    pReq->Len -= pReq->Chunk;
+
+    if (pReq->Len != 0U) {
+        DMACPY_StartChunk(pReq);
+    } else {
+        DMACPY_Finish(DMACPY_DONE);
+    }
+}
+
+// Channel transfer error (bus fault on an address): drop the request, go on with the next
+static void DMACPY_Error(uint8_t Channel, void *pContext) {
+    (void)Channel;
+    (void)pContext;
+    DMACPY_Finish(DMACPY_ERROR);
+}
+
+// Helper to queue a prepared request, starting the channel if it was idle
+static DMACPY_Status DMACPY_Submit(DMACPY_Request_t *pReq) {
+    uint32_t basepri;
+    uint8_t start;
+
+    pReq->pNext = 0;
+    pReq->Status = DMACPY_OK;
+
+    basepri = NVIC_EnterCritical();
+    start = (g_dmacpy_head == 0);
+    if (start) {
+        g_dmacpy_head = pReq;
+    } else {
+        g_dmacpy_tail->pNext = pReq;
+    }
+    g_dmacpy_tail = pReq;
+    NVIC_ExitCritical(basepri);
+
+    // Nothing else can start the channel while the queue holds only this request
+    if (start) {
+        DMACPY_StartChunk(pReq);
+    }
+    return DMACPY_OK;
+}
+
+// Helper to report a request the CPU completed on the spot
+static DMACPY_Status DMACPY_DoneNow(DMACPY_Request_t *pReq) {
+    pReq->Status = DMACPY_DONE;
+    pReq->Busy = 0;
+    if (pReq->pfnDone != 0) {
+        pReq->pfnDone(pReq, pReq->pContext);
+    }
+    return DMACPY_DONE;
+}
+
+// Helper to check a request can be (re)used and fill in the common fields
+static DMACPY_Status DMACPY_Prepare(DMACPY_Request_t *pReq, void *pDst, uint32_t Len,
+                                   DMACPY_Callback_t pfnDone, void *pContext) {
+    if (g_dmacpy_channel == DMA_CHANNEL_NONE) {
+        return DMACPY_ERROR;
+    }
+    if (pReq->Busy) {
+        return DMACPY_BUSY;
+    }
+
+    pReq->pDst = (uint8_t *)pDst;
+    pReq->Len = Len;
+    pReq->pfnDone = pfnDone;
+    pReq->pContext = pContext;
+    pReq->Busy = 1;
+    return DMACPY_OK;
+}
+
+// Helper to get the widest DMA item both addresses are aligned to
+static uint8_t DMACPY_Width(uint32_t Addresses) {
+    if (Addresses & 1U) return 1U;
+    else if (Addresses & 2U) return 2U;
+    else return 4U;
+}
+
+/**
+ * @brief  Claims a memory-to-memory DMA1 channel for the copy engine and
+ *         sets its interrupt to DMACPY_IRQ_PRIORITY.
+ * @return DMACPY_OK, or DMACPY_ERROR if every channel is taken
+ */
+DMACPY_Status DMACPY_Init(void) {
+    if (g_dmacpy_channel == DMA_CHANNEL_NONE) {
+        g_dmacpy_channel = DMA_Claim(DMA_REQ_MEM2MEM);
+        if (g_dmacpy_channel == DMA_CHANNEL_NONE) {
+            return DMACPY_ERROR;
+        }
+        DMA_SetCallbacks(g_dmacpy_channel, 0, DMACPY_Complete, DMACPY_Error, 0);
+        NVIC_SetPriority((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + g_dmacpy_channel - 1U), DMACPY_IRQ_PRIORITY);
+    }
+    return DMACPY_OK;
+}
+
+/**
+ * @brief  Copies Len bytes from pSrc to pDst in the background.
+ *         The regions must not overlap.
+ * @param  pReq: caller-owned request, not busy
+ * @param  pfnDone: called once the copy is done (or failed), may be 0
+ * @return DMACPY_OK (queued), DMACPY_DONE (short copy done by the CPU),
+ *         DMACPY_BUSY (pReq still in use) or DMACPY_ERROR (no DMACPY_Init)
+ */
+DMACPY_Status DMACPY_MemcpyAsync(DMACPY_Request_t *pReq, void *pDst, const void *pSrc, uint32_t Len,
+                                 DMACPY_Callback_t pfnDone, void *pContext) {
+    DMACPY_Status status = DMACPY_Prepare(pReq, pDst, Len, pfnDone, pContext);
+    uint32_t tail;
+
+    if (status != DMACPY_OK) {
+        return status;
+    }
+
+    if (Len < g_dmacpy_threshold) {
+        (void)memcpy(pDst, pSrc, Len);
+        return DMACPY_DoneNow(pReq);
+    }
+
+    pReq->pSrc = (const uint8_t *)pSrc;
+    pReq->IsFill = 0;
+    pReq->Width = DMACPY_Width((uint32_t)pDst | (uint32_t)pSrc);
+
+    // Bytes past the last whole item
+    tail = Len & (pReq->Width - 1U);
+    if (tail != 0U) {
+        pReq->Len -= tail;
+        (void)memcpy(pReq->pDst + pReq->Len, pReq->pSrc + pReq->Len, tail);
+    }
+    if (pReq->Len == 0U) {
+        return DMACPY_DoneNow(pReq);
+    }
+    return DMACPY_Submit(pReq);
+}
+
+/**
+ * @brief  Fills Len bytes at pDst with Value in the background. The DMA
+ *         reads the pattern from pReq->Fill without incrementing.
+ * @param  pReq: caller-owned request, not busy
+ * @param  pfnDone: called once the fill is done (or failed), may be 0
+ * @return As DMACPY_MemcpyAsync
+ */
+DMACPY_Status DMACPY_MemsetAsync(DMACPY_Request_t *pReq, void *pDst, uint8_t Value, uint32_t Len,
+                                 DMACPY_Callback_t pfnDone, void *pContext) {
+    DMACPY_Status status = DMACPY_Prepare(pReq, pDst, Len, pfnDone, pContext);
+    uint32_t tail;
+
+    if (status != DMACPY_OK) {
+        return status;
+    }
+
+    if (Len < g_dmacpy_threshold) {
+        (void)memset(pDst, Value, Len);
+        return DMACPY_DoneNow(pReq);
+    }
+
+    pReq->Fill = Value * 0x01010101U;
+    pReq->pSrc = (const uint8_t *)&pReq->Fill;
+    pReq->IsFill = 1;
+    pReq->Width = DMACPY_Width((uint32_t)pDst);
+
+    tail = Len & (pReq->Width - 1U);
+    if (tail != 0U) {
+        pReq->Len -= tail;
+        (void)memset(pReq->pDst + pReq->Len, Value, tail);
+    }
+    if (pReq->Len == 0U) {
+        return DMACPY_DoneNow(pReq);
+    }
+    return DMACPY_Submit(pReq);
+}
+
+/**
+ * @brief  1 while the request is queued or running
+ */
+uint8_t DMACPY_IsBusy(const DMACPY_Request_t *pReq) {
+    return pReq->Busy;
+}
+
+/**
+ * @brief  Sets the size below which requests are done by the CPU
+ *         (0 sends everything to the DMA)
+ */
+void DMACPY_SetCpuThreshold(uint32_t Bytes) {
+    g_dmacpy_threshold = Bytes;
+}
+
+uint32_t DMACPY_GetCpuThreshold(void) {
+    return g_dmacpy_threshold;
+}
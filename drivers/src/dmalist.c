@@ -0,0 +1,201 @@
+#include "dmalist.h"
+
+/*
+ * Transfer complete: restart the channel on the next node first, so the
+ * peripheral only waits for these few register writes, then report.
+ * Runs from SRAM to keep flash wait states out of the gap.
+ */
+static RAMFUNC void DMAL_Complete(uint8_t Channel, void *pContext) {
+    DMAL_List_t *pList = (DMAL_List_t *)pContext;
+    DMA_Channel_TypeDef *pChannel = pList->pChannel;
+    DMAL_Node_t *pDone = pList->pCurrent;
+    DMAL_Node_t *pNext = pDone->pNext;
+    (void)Channel;
+
+    // CMAR/CNDTR are only writable while the channel is disabled
+    pChannel->CCR = pList->CcrRun & ~DMA_CCR_EN;
+    if ((pNext != 0) && pList->Running) {
+        pChannel->CMAR = pNext->MemoryAddr;
+        pChannel->CNDTR = pNext->Count;
+        pChannel->CCR = pList->CcrRun;
+        pList->pCurrent = pNext;
+    } else {
+        pList->Running = 0;
+    }
+
+    pList->NodesDone++;
+    if (pList->pfnNodeDone != 0) {
+        pList->pfnNodeDone(pList, pDone, pList->pContext);
+    }
+}
+
+// Transfer error: the hardware has disabled the channel, the list stops
+static void DMAL_Error(uint8_t Channel, void *pContext) {
+    DMAL_List_t *pList = (DMAL_List_t *)pContext;
+    (void)Channel;
+
+    pList->Running = 0;
+    if (pList->pfnError != 0) {
+        pList->pfnError(pList, pList->pCurrent, pList->pContext);
+    }
+}
+
+/**
+ * @brief  Claims the channel of a request and programs the fixed part of
+ *         the list: peripheral address, direction, widths, increments and
+ *         priority from pInit. Its memory address, buffer size, mode and
+ *         interrupt fields are ignored (the nodes and the list own them).
+ * @param  Request: a value of @ref DMA_Requests (DMA_REQ_MEM2MEM for
+ *         memory-to-memory with DMA_M2M_Enable in pInit)
+ * @param  pfnNodeDone: called per finished node, may be 0
+ * @param  pfnError: called on a transfer error, may be 0
+ * @return DMAL_OK, or DMAL_BUSY if the channel is taken
+ */
+DMAL_Status DMAL_Init(DMAL_List_t *pList, uint8_t Request, const DMA_Init_t *pInit,
+                      DMAL_Callback_t pfnNodeDone, DMAL_Callback_t pfnError, void *pContext) {
+    DMA_Init_t dmaInit = *pInit;
+    uint8_t channel = DMA_Claim(Request);
+
+    if (channel == DMA_CHANNEL_NONE) {
+        return DMAL_BUSY;
+    }
+
+    pList->Channel = channel;
+    pList->pChannel = DMA_GetChannel(channel);
+    pList->pCurrent = 0;
+    pList->pfnNodeDone = pfnNodeDone;
+    pList->pfnError = pfnError;
+    pList->pContext = pContext;
+    pList->NodesDone = 0;
+    pList->Running = 0;
+
+    // Each node is a normal-mode transfer; the interrupt chains them
+    dmaInit.DMA_MemoryBaseAddr = 0;
+    dmaInit.DMA_BufferSize = 0;
+    dmaInit.DMA_Mode = DMA_Mode_Normal;
+    dmaInit.DMA_IT = DMA_IT_TC | DMA_IT_TE;
+    DMA_Init(pList->pChannel, &dmaInit);
+    pList->CcrRun = pList->pChannel->CCR | DMA_CCR_EN;
+
+    DMA_SetCallbacks(channel, 0, DMAL_Complete, DMAL_Error, pList);
+    return DMAL_OK;
+}
+
+/**
+ * @brief  Stops the list and releases its channel
+ */
+void DMAL_DeInit(DMAL_List_t *pList) {
+    DMAL_Stop(pList);
+    DMA_Release(pList->Channel);
+    pList->Channel = DMA_CHANNEL_NONE;
+}
+
+// Helper to check every node reachable from pFirst has items; a ring is walked once round (Floyd)
+static uint8_t DMAL_NodesValid(const DMAL_Node_t *pFirst) {
+    const DMAL_Node_t *pSlow = pFirst;
+    const DMAL_Node_t *pFast = pFirst;
+
+    if ((pFirst == 0) || (pFirst->Count == 0U)) {
+        return 0;
+    }
+    for (;;) {
+        // By the time the pointers meet, pFast has been all the way round the ring
+        for (uint8_t step = 0; step < 2U; step++) {
+            pFast = pFast->pNext;
+            if (pFast == 0) {
+                return 1;
+            }
+            if (pFast->Count == 0U) {
+                return 0;
+            }
+        }
+        pSlow = pSlow->pNext;
+        if (pSlow == pFast) {
+            return 1;
+        }
+    }
+}
+
+/**
+ * @brief  Starts the transfer of pFirst and the nodes linked after it
+ * @return DMAL_OK, DMAL_BUSY if the list is running, DMAL_ERROR if any
+ *         node of the chain or ring has a Count of 0 (it would never complete)
+ */
+DMAL_Status DMAL_Start(DMAL_List_t *pList, DMAL_Node_t *pFirst) {
+    DMA_Channel_TypeDef *pChannel = pList->pChannel;
+
+    if (pList->Running) {
+        return DMAL_BUSY;
+    }
+    if (!DMAL_NodesValid(pFirst)) {
+        return DMAL_ERROR;
+    }
+
+    pList->pCurrent = pFirst;
+    pList->NodesDone = 0;
+    pList->Running = 1;
+
+    pChannel->CCR = pList->CcrRun & ~DMA_CCR_EN;
+    DMA_ClearFlag(DMA1, DMA_FLAG_GL(pList->Channel));
+    pChannel->CMAR = pFirst->MemoryAddr;
+    pChannel->CNDTR = pFirst->Count;
+    pChannel->CCR = pList->CcrRun;
+    return DMAL_OK;
+}
+
+/**
+ * @brief  Stops the list at once, also a ring: the node in flight is
+ *         aborted mid-transfer and not reported to pfnNodeDone. CNDTR of
+ *         the channel still tells how many of its items were left.
+ */
+void DMAL_Stop(DMAL_List_t *pList) {
+    // Cleared first so a completion interrupt in between does not chain on
+    pList->Running = 0;
+    COMPILER_BARRIER();
+    pList->pChannel->CCR = pList->CcrRun & ~DMA_CCR_EN;
+    DMA_ClearFlag(DMA1, DMA_FLAG_GL(pList->Channel));
+}
+
+/**
+ * @brief  1 until the last node of a chain has completed (or DMAL_Stop)
+ */
+uint8_t DMAL_IsRunning(const DMAL_List_t *pList) {
+    return pList->Running;
+}
+
+/**
+ * @brief  Links NumNodes buffers of Count items each into a chain that ends
+ *         after the last one.
+ * @param  pNodes: NumNodes nodes
+ * @param  ppBuffers: NumNodes buffers, need not be contiguous
+ */
+void DMAL_BuildChain(DMAL_Node_t *pNodes, uint8_t *const *ppBuffers, uint8_t NumNodes, uint16_t Count) {
+    for (uint8_t i = 0; i < NumNodes; i++) {
+        pNodes[i].MemoryAddr = (uint32_t)ppBuffers[i];
+        pNodes[i].Count = Count;
+        pNodes[i].pNext = (i + 1U < NumNodes) ? &pNodes[i + 1U] : 0;
+    }
+}
+
+/**
+ * @brief  As DMAL_BuildChain, with the last node linked back to the first:
+ *         an N-buffer ring that streams until DMAL_Stop.
+ */
+void DMAL_BuildRing(DMAL_Node_t *pNodes, uint8_t *const *ppBuffers, uint8_t NumNodes, uint16_t Count) {
+    DMAL_BuildChain(pNodes, ppBuffers, NumNodes, Count);
+    if (NumNodes != 0U) {
+        pNodes[NumNodes - 1U].pNext = &pNodes[0];
+    }
+}
+
+/**
+ * @brief  Two-buffer ring: the callback processes one buffer while the DMA
+ *         fills or drains the other.
+ */
+void DMAL_BuildPingPong(DMAL_Node_t pNodes[2], uint8_t *pPing, uint8_t *pPong, uint16_t Count) {
+    uint8_t *buffers[2];
+
+    buffers[0] = pPing;
+    buffers[1] = pPong;
+    DMAL_BuildRing(pNodes, buffers, 2, Count);
+}
@@ -0,0 +1,114 @@
+#include "dwt.h"
+#include "rcc.h"
+
+static uint32_t g_cycles_per_us = 8; // HSI until DWT_Init
+static RCC_ClockNotifier_t g_dwt_notifier;
+
+/* Clock change listener: conversions follow the new HCLK */
+static void DWT_ClockNotify(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext) {
+    (void)pContext;
+    if (Event == RCC_CLOCK_EVENT_POST_CHANGE) {
+        g_cycles_per_us = pClocks->HCLK_Frequency / 1000000U;
+    }
+}
+
+/**
+ * @brief  Starts the DWT cycle counter and caches the core clock for the
+ *         conversion helpers. Safe to call more than once; the counter is
+ *         not reset.
+ */
+void DWT_Init(void) {
+    RCC_Clocks_t clocks;
+
+    // Trace must be enabled for the DWT to count
+    CoreDebug->DEMCR |= COREDEBUG_DEMCR_TRCENA;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+
+    RCC_GetClocksFreq(&clocks);
+    g_cycles_per_us = clocks.HCLK_Frequency / 1000000U;
+
+    g_dwt_notifier.pfnNotify = DWT_ClockNotify;
+    RCC_RegisterClockNotifier(&g_dwt_notifier);
+}
+
+/**
+ * @brief  Busy-waits for at least the given number of core cycles.
+ *         Resolution is one counter read (a few cycles); interrupts that
+ *         fire during the wait are included, not added.
+ * @param  cycles: cycles to wait, up to 2^31 for a correct result
+ */
+void delay_cycles(uint32_t cycles) {
+    uint32_t start = DWT->CYCCNT;
+    while ((uint32_t)(DWT->CYCCNT - start) < cycles) {
+    }
+}
+
+/**
+ * @brief  Converts microseconds to core cycles at the current HCLK
+ */
+uint32_t us_to_cycles(uint32_t us) {
+    return us * g_cycles_per_us;
+}
+
+/**
+ * @brief  Converts core cycles to whole microseconds at the current HCLK
+ */
+uint32_t cycles_to_us(uint32_t cycles) {
+    return cycles / g_cycles_per_us;
+}
+
+/**
+ * @brief  Converts core cycles to nanoseconds at the current HCLK
+ */
+uint32_t cycles_to_ns(uint32_t cycles) {
+    // Split so no 64-bit division is needed (the link has no libgcc)
+    return ((cycles / g_cycles_per_us) * 1000U) + (((cycles % g_cycles_per_us) * 1000U) / g_cycles_per_us);
+}
+
+/**
+ * @brief  Clears a profiling accumulator
+ * @param  pStats: accumulator to clear
+ */
+void DWT_CycleStatsReset(DWT_CycleStats_t *pStats) {
+    pStats->Count = 0;
+    pStats->Min = 0xFFFFFFFFU;
+    pStats->Max = 0;
+    pStats->Total = 0;
+}
+
+/**
+ * @brief  Records one measurement, typically cycles_now() - start
+ * @param  pStats: accumulator
+ * @param  cycles: duration of one pass through the profiled path
+ */
+void DWT_CycleStatsAdd(DWT_CycleStats_t *pStats, uint32_t cycles) {
+    pStats->Count++;
+    pStats->Total += cycles;
+    if (cycles < pStats->Min) pStats->Min = cycles;
+    if (cycles > pStats->Max) pStats->Max = cycles;
+}
+
+/**
+ * @brief  Mean of the recorded measurements
+ * @param  pStats: accumulator
+ * @return Average cycles, 0 if nothing was recorded
+ */
+uint32_t DWT_CycleStatsAverage(const DWT_CycleStats_t *pStats) {
+    uint64_t rem = pStats->Total;
+    uint32_t avg = 0;
+    int32_t bit;
+
+    if (pStats->Count == 0) {
+        return 0;
+    }
+
+    // Shift-subtract division (no libgcc for 64-bit '/'); the mean is <= Max so it fits 32 bits
+    for (bit = 31; bit >= 0; bit--) {
+        uint64_t step = (uint64_t)pStats->Count << bit;
+        if (rem >= step) {
+            rem -= step;
+            avg |= (1UL << bit);
+        }
+    }
+    return avg;
+}
@@ -145,3 +145,52 @@ FLASH_Status FLASH_WaitForLastOperation(uint32_t Timeout) {
     
     return status;
 }
+
+/**
+ * @brief  Prepares a resumable page erase; run it with FLASH_ErasePage_PT.
+ *         The FPEC must already be unlocked.
+ * @param  pReq: caller-owned request, must stay valid until the erase ends.
+ * @param  Page_Address: The page address to be erased.
+ */
+void FLASH_ErasePageStart(FLASH_EraseReq_t *pReq, uint32_t Page_Address) {
+    PT_INIT(&pReq->pt);
+    pReq->PageAddress = Page_Address;
+    pReq->Status = FLASH_BUSY;
+}
+
+/**
+ * @brief  Page erase as a coroutine: starts the erase and returns while BSY
+ *         is set instead of spinning in FLASH_WaitForLastOperation.
+ *         Note that the CPU stalls on any fetch from flash while the erase
+ *         runs, so the rest of the loop only makes progress if it executes
+ *         from RAM; otherwise the gain is that the wait is bounded in ms.
+ * @param  pReq: request prepared by FLASH_ErasePageStart.
+ * @return PT_WAITING while in progress, PT_ENDED when done; pReq->Status
+ *         then holds FLASH_COMPLETE, FLASH_ERROR_PG, FLASH_ERROR_WRP or
+ *         FLASH_TIMEOUT.
+ */
+char FLASH_ErasePage_PT(FLASH_EraseReq_t *pReq) {
+    PT_BEGIN(&pReq->pt);
+
+    /* Wait for last operation to be completed */
+    PT_WAIT_TIMEOUT(&pReq->pt, (FLASH->SR & FLASH_FLAG_BSY) == 0, &pReq->Timeout, FLASH_PT_ERASE_TIMEOUT_MS);
+    if ((FLASH->SR & FLASH_FLAG_BSY) != 0) {
+        pReq->Status = FLASH_TIMEOUT;
+        PT_EXIT(&pReq->pt);
+    }
+
+    FLASH->CR |= (1 << 1); // PER bit
+    FLASH->AR = pReq->PageAddress;
+    FLASH->CR |= (1 << 6); // STRT bit
+
+    PT_WAIT_TIMEOUT(&pReq->pt, (FLASH->SR & FLASH_FLAG_BSY) == 0, &pReq->Timeout, FLASH_PT_ERASE_TIMEOUT_MS);
+    pReq->Status = FLASH_GetStatus();
+    if (pReq->Status == FLASH_BUSY) {
+        pReq->Status = FLASH_TIMEOUT;
+    }
+
+    /* Disable the PER Bit */
+    FLASH->CR &= ~(1 << 1);
+
+    PT_END(&pReq->pt);
+}
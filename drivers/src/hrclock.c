@@ -0,0 +1,113 @@
+#include "hrclock.h"
+
+static TIM_Handle_t g_hrc_low;
+static TIM_Handle_t g_hrc_high;
+static volatile uint32_t g_hrc_upper;   // TIM3 overflows: bits 63..32
+
+/**
+ * @brief  Chains TIM2 (low half, 1MHz) and TIM3 (high half) into a 32-bit
+ *         counter and starts it. The TIM3 interrupt must be enabled and
+ *         routed to HRC_IRQHandler for HRC_Now64; it fires once per 2^32 us.
+ */
+void HRC_Init(void) {
+    // High half: counts TIM2 overflows, no internal prescaling
+    g_hrc_high.pTIMx = HRC_HIGH_TIM;
+    g_hrc_high.BaseConfig.Prescaler = 0;
+    g_hrc_high.BaseConfig.Period = 0xFFFF;
+    g_hrc_high.BaseConfig.CounterMode = TIM_COUNTERMODE_UP;
+    g_hrc_high.BaseConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    g_hrc_high.BaseConfig.SlaveMode = TIM_SLAVEMODE_EXTERNAL1;
+    g_hrc_high.BaseConfig.InputTrigger = HRC_HIGH_TRIGGER;
+    TIM_Base_Init(&g_hrc_high);
+
+    // Low half: 1MHz, TRGO pulses on every overflow
+    g_hrc_low.pTIMx = HRC_LOW_TIM;
+    g_hrc_low.BaseConfig.Prescaler = TIM_CalcPrescaler(HRC_LOW_TIM, HRC_FREQ_HZ);
+    g_hrc_low.BaseConfig.Period = 0xFFFF;
+    g_hrc_low.BaseConfig.CounterMode = TIM_COUNTERMODE_UP;
+    g_hrc_low.BaseConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    g_hrc_low.BaseConfig.SlaveMode = TIM_SLAVEMODE_DISABLE;
+    g_hrc_low.BaseConfig.InputTrigger = TIM_TS_ITR0;
+    TIM_Base_Init(&g_hrc_low);
+
+    // Load PSC/ARR now; URS stops the UG from counting as an overflow
+    HRC_HIGH_TIM->CR1 |= TIM_CR1_URS;
+    HRC_HIGH_TIM->EGR = TIM_EGR_UG;
+    HRC_HIGH_TIM->CNT = 0;
+    HRC_HIGH_TIM->SR = 0;
+    HRC_LOW_TIM->CR1 |= TIM_CR1_URS;
+    HRC_LOW_TIM->EGR = TIM_EGR_UG;
+    HRC_LOW_TIM->CNT = 0;
+    HRC_LOW_TIM->SR = 0;
+    g_hrc_upper = 0;
+
+    // Slave first so no TIM2 overflow is missed
+    HRC_HIGH_TIM->DIER |= TIM_DIER_UIE;
+    TIM_Base_Start(HRC_HIGH_TIM);
+    TIM_Base_Start(HRC_LOW_TIM);
+}
+
+/**
+ * @brief  Reads the 32-bit hardware counter in microseconds.
+ *         No interrupt needed. Uses the same high/low/high sequence as
+ *         RTC_GetCounter so a carry between the halves is never torn.
+ * @return Microseconds, wrapping every 2^32 us.
+ */
+uint32_t HRC_Now32(void) {
+    uint16_t high1 = 0, high2 = 0, low = 0;
+    high1 = HRC_HIGH_TIM->CNT;
+    low = HRC_LOW_TIM->CNT;
+    high2 = HRC_HIGH_TIM->CNT;
+
+    if (high1 != high2) { /* TIM2 rolled over between the reads */
+        return (((uint32_t)high2 << 16) | (uint16_t)HRC_LOW_TIM->CNT);
+    } else {
+        return (((uint32_t)high1 << 16) | low);
+    }
+}
+
+/**
+ * @brief  Reads the 64-bit microsecond clock. Safe from any context,
+ *         including interrupts that preempt HRC_IRQHandler.
+ * @return Microseconds since HRC_Init.
+ */
+uint64_t HRC_Now64(void) {
+    uint32_t upper1, upper2, now;
+    uint8_t pending;
+
+    do {
+        upper1 = g_hrc_upper;
+        now = HRC_Now32();
+        pending = (HRC_HIGH_TIM->SR & TIM_SR_UIF) ? 1U : 0U;
+        upper2 = g_hrc_upper;
+    } while (upper1 != upper2);
+
+    // Overflow happened but HRC_IRQHandler has not accounted for it yet
+    if (pending && (now < 0x80000000U)) {
+        upper1++;
+    }
+    return ((uint64_t)upper1 << 32) | now;
+}
+
+/**
+ * @brief  Widens a 16-bit TIM2 input-capture value to the 64-bit clock.
+ *         The capture must be less than 65.5 ms old when this is called.
+ * @param  Capture: CCRx value captured by TIM2 (same 1MHz counter).
+ * @return Microsecond timestamp of the captured edge.
+ */
+uint64_t HRC_ExtendCapture(uint16_t Capture) {
+    uint64_t now = HRC_Now64();
+    uint16_t age = (uint16_t)((uint16_t)now - Capture);
+    return now - age;
+}
+
+/**
+ * @brief  TIM3 overflow handler: advances the upper 32 bits.
+ *         Call from the TIM3 interrupt vector.
+ */
+void HRC_IRQHandler(void) {
+    if (HRC_HIGH_TIM->SR & TIM_SR_UIF) {
+        HRC_HIGH_TIM->SR = ~TIM_SR_UIF;
+        g_hrc_upper++;
+    }
+}
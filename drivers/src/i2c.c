@@ -1,31 +1,33 @@
 #include "i2c.h"
 #include "rcc.h" // For getting PCLK1 frequency
 
+/* Per-instance state for re-tuning on clock changes */
+typedef struct {
+    RCC_ClockNotifier_t Notifier;
+    I2C_TypeDef *I2Cx;
+    uint32_t ClockSpeed;
+    uint16_t SavedCR1PE;
+} I2C_ClockState_t;
+
+static I2C_ClockState_t g_i2c_clock_state[2];
+
 /**
- * @brief  Initializes the I2Cx peripheral according to the specified 
- *         parameters in the I2C_InitStruct.
+ * @brief  Programs CR2 FREQ, CCR and TRISE for the given bus speed and PCLK1.
+ *         The peripheral is left disabled (PE = 0).
  * @param  I2Cx: where x can be 1 or 2 to select the I2C peripheral.
- * @param  I2C_InitStruct: pointer to a I2C_Config_t structure that
- *         contains the configuration information for the specified I2C peripheral.
+ * @param  ClockSpeed: SCL frequency in Hz.
+ * @param  pclk1: APB1 clock in Hz.
  */
-void I2C_Init(I2C_TypeDef* I2Cx, I2C_Config_t* I2C_InitStruct) {
+static void I2C_ConfigTiming(I2C_TypeDef* I2Cx, uint32_t ClockSpeed, uint32_t pclk1) {
     uint16_t tmpreg = 0;
     uint16_t freqrange = 0;
     uint16_t result = 0;
-    uint32_t pclk1 = 8000000; // Default 8MHz if we can't determine
 
-    // Note: In a real driver, we should get PCLK1 from RCC.
-    // For now, assuming 8MHz or user ensures PCLK1 is set correctly.
-    // Let's assume 8MHz for calculation simplicity or 36MHz max.
-    // Ideally: pclk1 = RCC_GetPCLK1Freq();
-    
     /*---------------------------- I2Cx CR2 Configuration ------------------------*/
     /* Get the I2Cx CR2 value */
     tmpreg = I2Cx->CR2;
     /* Clear FREQ[5:0] bits */
     tmpreg &= 0xFFC0;
-    /* Get the PCLK1 frequency value */
-    pclk1 = 8000000; // Placeholder: Should be dynamic
     
     /* Set frequency bits depending on pclk1 value */
     freqrange = (uint16_t)(pclk1 / 1000000);
@@ -40,12 +42,12 @@ void I2C_Init(I2C_TypeDef* I2Cx, I2C_Config_t* I2C_InitStruct) {
     /* Get the I2Cx CCR value */
     tmpreg = 0;
     
-    if (I2C_InitStruct->I2C_ClockSpeed <= 100000) { /* Standard mode */
+    if (ClockSpeed <= 100000) { /* Standard mode */
         /* Configure speed in standard mode */
         /* Standard mode speed calculation */
         /* Thigh = CCR * TPCLK1 => CCR = Thigh / TPCLK1 = (Tr / 2) / TPCLK1 */
         /* CCR = PCLK1 / (2 * Speed) */
-        result = (uint16_t)(pclk1 / (I2C_InitStruct->I2C_ClockSpeed << 1));
+        result = (uint16_t)(pclk1 / (ClockSpeed << 1));
         
         /* Set speed value for standard mode */
         if (result < 0x04) {
@@ -62,6 +64,55 @@ void I2C_Init(I2C_TypeDef* I2Cx, I2C_Config_t* I2C_InitStruct) {
     } else { /* Fast mode */
         // Fast mode implementation omitted for brevity, similar logic
     }
+}
+
+/* Clock change listener: finish the current transfer, then recompute timing */
+static void I2C_ClockNotify(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext) {
+    I2C_ClockState_t *pState = (I2C_ClockState_t *)pContext;
+    volatile uint32_t timeout = 0;
+
+    if (Event == RCC_CLOCK_EVENT_PRE_CHANGE) {
+        /* Wait for the bus to go idle (SR2 BUSY) so no byte is clocked at a wrong SCL */
+        while (pState->I2Cx->SR2 & 0x0002) {
+            if (++timeout > 100000) break;
+        }
+        pState->SavedCR1PE = (uint16_t)(pState->I2Cx->CR1 & 0x0001);
+    } else {
+        I2C_ConfigTiming(pState->I2Cx, pState->ClockSpeed, pClocks->PCLK1_Frequency);
+        pState->I2Cx->CR1 |= pState->SavedCR1PE;
+    }
+}
+
+/* Records the bus speed of I2Cx and registers its clock listener */
+static void I2C_RegisterClockNotifier(I2C_TypeDef* I2Cx, uint32_t ClockSpeed) {
+    I2C_ClockState_t *pState = &g_i2c_clock_state[(I2Cx == I2C1) ? 0 : 1];
+
+    pState->I2Cx = I2Cx;
+    pState->ClockSpeed = ClockSpeed;
+    pState->Notifier.pfnNotify = I2C_ClockNotify;
+    pState->Notifier.pContext = pState;
+    RCC_RegisterClockNotifier(&pState->Notifier);
+}
+
+/**
+ * @brief  Initializes the I2Cx peripheral according to the specified 
+ *         parameters in the I2C_InitStruct.
+ * @param  I2Cx: where x can be 1 or 2 to select the I2C peripheral.
+ * @param  I2C_InitStruct: pointer to a I2C_Config_t structure that
+ *         contains the configuration information for the specified I2C peripheral.
+ */
+void I2C_Init(I2C_TypeDef* I2Cx, I2C_Config_t* I2C_InitStruct) {
+    uint16_t tmpreg = 0;
+    RCC_Clocks_t rcc_clocks;
+
+    /* Get the PCLK1 frequency value */
+    RCC_GetClocksFreq(&rcc_clocks);
+
+    /*---------------------------- I2Cx CR2/CCR/TRISE Configuration --------------*/
+    I2C_ConfigTiming(I2Cx, I2C_InitStruct->I2C_ClockSpeed, rcc_clocks.PCLK1_Frequency);
+
+    /* Re-tune CCR/TRISE whenever the clock tree changes */
+    I2C_RegisterClockNotifier(I2Cx, I2C_InitStruct->I2C_ClockSpeed);
 
     /*---------------------------- I2Cx CR1 Configuration ------------------------*/
     /* Get the I2Cx CR1 value */
@@ -165,3 +216,132 @@ uint8_t I2C_ReceiveData(I2C_TypeDef* I2Cx) {
     /* Return the data in the DR register */
     return (uint8_t)I2Cx->DR;
 }
+
+/**
+ * @brief  Prepares a resumable register read; run it with I2C_ReadReg_PT.
+ * @param  pReq: caller-owned request, must stay valid until the read ends.
+ * @param  I2Cx: where x can be 1 or 2 to select the I2C peripheral.
+ * @param  DevAddress: 8-bit slave address (7-bit address << 1).
+ * @param  Reg: register to start reading from.
+ * @param  pData: destination buffer.
+ * @param  Len: number of bytes to read (at least 1; 0 ends with I2C_ERROR).
+ */
+void I2C_ReadRegStart(I2C_ReadReg_t *pReq, I2C_TypeDef* I2Cx, uint8_t DevAddress, uint8_t Reg, uint8_t *pData, uint16_t Len) {
+    PT_INIT(&pReq->pt);
+    pReq->I2Cx = I2Cx;
+    pReq->DevAddress = DevAddress;
+    pReq->Reg = Reg;
+    pReq->pData = pData;
+    pReq->Len = Len;
+    pReq->Index = 0;
+    pReq->Status = I2C_BUSY;
+}
+
+/* Waits for cond with the per-step timeout; on expiry releases the bus and ends the read */
+#define I2C_PT_AWAIT(pReq, cond) \
+    do { \
+        PT_WAIT_TIMEOUT(&(pReq)->pt, (cond), &(pReq)->Timeout, I2C_PT_TIMEOUT_MS); \
+        if (!(cond)) { \
+            I2C_ReadRegAbort((pReq), I2C_TIMEOUT); \
+            PT_EXIT(&(pReq)->pt); \
+        } \
+    } while (0)
+
+// Helper to end a failed read with a STOP and the default ACK/POS setting
+static void I2C_ReadRegAbort(I2C_ReadReg_t *pReq, I2C_Status Status) {
+    pReq->I2Cx->CR1 |= I2C_CR1_STOP;
+    pReq->I2Cx->CR1 = (uint16_t)((pReq->I2Cx->CR1 | I2C_CR1_ACK) & ~I2C_CR1_POS);
+    pReq->Status = Status;
+}
+
+/**
+ * @brief  Register read as a coroutine: write Reg, repeated START, read Len
+ *         bytes. Each call advances as far as the hardware allows and
+ *         returns instead of spinning on SR1.
+ *         Reception uses the BTF method of the reference manual, in which
+ *         SCL is stretched while the last bytes are pending, so a late
+ *         resume does not lose the NACK/STOP timing.
+ * @param  pReq: request prepared by I2C_ReadRegStart.
+ * @return PT_WAITING while in progress, PT_ENDED/PT_EXITED when done;
+ *         pReq->Status then holds the result.
+ */
+char I2C_ReadReg_PT(I2C_ReadReg_t *pReq) {
+    I2C_TypeDef *I2Cx = pReq->I2Cx;
+    uint16_t tmp;
+
+    PT_BEGIN(&pReq->pt);
+
+    /* Len - 3 below would wrap; nothing has touched the bus yet */
+    if (pReq->Len == 0U) {
+        pReq->Status = I2C_ERROR;
+        PT_EXIT(&pReq->pt);
+    }
+
+    /* Bus free, START, address for write */
+    I2C_PT_AWAIT(pReq, (I2Cx->SR2 & I2C_SR2_BUSY) == 0);
+    I2Cx->CR1 |= I2C_CR1_START;
+    I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_SB);
+    I2C_Send7bitAddress(I2Cx, pReq->DevAddress, 0);
+    I2C_PT_AWAIT(pReq, I2Cx->SR1 & (I2C_SR1_ADDR | I2C_SR1_AF));
+    if (I2Cx->SR1 & I2C_SR1_AF) {
+        I2Cx->SR1 &= (uint16_t)~I2C_SR1_AF;
+        I2C_ReadRegAbort(pReq, I2C_NACK);
+        PT_EXIT(&pReq->pt);
+    }
+    tmp = (uint16_t)I2Cx->SR2; /* SR1 then SR2 read clears ADDR */
+    (void)tmp;
+
+    /* Register index */
+    I2Cx->DR = pReq->Reg;
+    I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_BTF);
+
+    /* Repeated START, address for read */
+    I2Cx->CR1 |= I2C_CR1_START;
+    I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_SB);
+    I2C_Send7bitAddress(I2Cx, pReq->DevAddress, 1);
+    I2C_PT_AWAIT(pReq, I2Cx->SR1 & (I2C_SR1_ADDR | I2C_SR1_AF));
+    if (I2Cx->SR1 & I2C_SR1_AF) {
+        I2Cx->SR1 &= (uint16_t)~I2C_SR1_AF;
+        I2C_ReadRegAbort(pReq, I2C_NACK);
+        PT_EXIT(&pReq->pt);
+    }
+
+    if (pReq->Len == 1) {
+        /* NACK the only byte, STOP right after ADDR is cleared */
+        I2Cx->CR1 &= (uint16_t)~I2C_CR1_ACK;
+        tmp = (uint16_t)I2Cx->SR2;
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_RXNE);
+        pReq->pData[0] = (uint8_t)I2Cx->DR;
+    } else if (pReq->Len == 2) {
+        /* POS: the NACK applies to the second byte */
+        I2Cx->CR1 = (uint16_t)((I2Cx->CR1 | I2C_CR1_POS) & ~I2C_CR1_ACK);
+        tmp = (uint16_t)I2Cx->SR2;
+        I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_BTF);
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        pReq->pData[0] = (uint8_t)I2Cx->DR;
+        pReq->pData[1] = (uint8_t)I2Cx->DR;
+    } else {
+        I2Cx->CR1 |= I2C_CR1_ACK;
+        tmp = (uint16_t)I2Cx->SR2;
+        for (pReq->Index = 0; pReq->Index < (uint16_t)(pReq->Len - 3U); pReq->Index++) {
+            I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_RXNE);
+            pReq->pData[pReq->Index] = (uint8_t)I2Cx->DR;
+        }
+        /* Last three bytes: N-2 in DR, N-1 in the shift register */
+        I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_BTF);
+        I2Cx->CR1 &= (uint16_t)~I2C_CR1_ACK;
+        pReq->pData[pReq->Index++] = (uint8_t)I2Cx->DR;
+        I2C_PT_AWAIT(pReq, I2Cx->SR1 & I2C_SR1_BTF);
+        I2Cx->CR1 |= I2C_CR1_STOP;
+        pReq->pData[pReq->Index++] = (uint8_t)I2Cx->DR;
+        pReq->pData[pReq->Index++] = (uint8_t)I2Cx->DR;
+    }
+    (void)tmp;
+
+    /* Restore ACK/POS for the next transfer */
+    I2Cx->CR1 = (uint16_t)((I2Cx->CR1 | I2C_CR1_ACK) & ~I2C_CR1_POS);
+    pReq->Status = I2C_OK;
+
+    PT_END(&pReq->pt);
+}
@@ -0,0 +1,532 @@
+#include "kernel.h"
+#include "nvic.h"
+
+#define OS_PRIO_BIT(prio)       (0x80000000UL >> (prio))
+#define OS_MIN_STACK_WORDS      32U     // Exception frame + R4-R11 + some room
+
+/*
+ * Scheduler state. g_os_current/g_os_next are read by the PendSV and SVC
+ * handlers below by symbol name.
+ */
+static OS_Task_t *g_os_tasks[OS_MAX_TASKS];
+static volatile uint32_t g_os_ready;      // Bit (31 - prio) set when ready
+static volatile uint32_t g_os_delayed;    // Bit (31 - prio) set when a delay/timeout runs
+static volatile uint8_t g_os_running;
+static volatile OS_Hook_t g_os_pendsv_hook;  // Run by the default PendSV_Callback
+__attribute__((used)) static OS_Task_t *volatile g_os_current;
+__attribute__((used)) static OS_Task_t *volatile g_os_next;
+
+static OS_Task_t g_os_idle_task;
+static uint32_t g_os_idle_stack[OS_IDLE_STACK_WORDS] __attribute__((aligned(8)));
+
+// Helper to pick the highest-priority ready task and pend PendSV if it changes
+static void OS_Schedule(void) {
+    OS_Task_t *pNext;
+
+    if (!g_os_running) {
+        return;
+    }
+    pNext = g_os_tasks[__builtin_clz(g_os_ready)];
+    g_os_next = pNext;
+    if (pNext != g_os_current) {
+        SCB->ICSR = SCB_ICSR_PENDSVSET;
+    }
+}
+
+// Helper to block the current task on a wait mask; called inside a critical section which it ends
+static OS_Status OS_Block(volatile uint32_t *pWaitMask, uint32_t Timeout, uint32_t basepri) {
+    OS_Task_t *pTask = g_os_current;
+    uint32_t bit = OS_PRIO_BIT(pTask->Priority);
+
+    g_os_ready &= ~bit;
+    *pWaitMask |= bit;
+    pTask->pWaitMask = pWaitMask;
+    pTask->WaitResult = OS_TIMEOUT;
+    pTask->State = OS_TASK_BLOCKED;
+    if (Timeout != OS_WAIT_FOREVER) {
+        pTask->DelayTicks = Timeout;
+        g_os_delayed |= bit;
+    }
+    OS_Schedule();
+
+    // PendSV switches away as soon as interrupts are unmasked
+    NVIC_ExitCritical(basepri);
+    return pTask->WaitResult;
+}
+
+// Helper to make the highest-priority waiter of a wait mask ready
+static OS_Task_t *OS_WakeOne(volatile uint32_t *pWaitMask, OS_Status Result) {
+    uint32_t prio = (uint32_t)__builtin_clz(*pWaitMask);
+    uint32_t bit = OS_PRIO_BIT(prio);
+    OS_Task_t *pTask = g_os_tasks[prio];
+
+    *pWaitMask &= ~bit;
+    g_os_delayed &= ~bit;
+    pTask->pWaitMask = 0;
+    pTask->WaitResult = Result;
+    pTask->State = OS_TASK_READY;
+    g_os_ready |= bit;
+    return pTask;
+}
+
+// Helper to copy one queue item
+static void OS_CopyItem(uint8_t *pDst, const uint8_t *pSrc, uint16_t Size) {
+    while (Size--) {
+        *pDst++ = *pSrc++;
+    }
+}
+
+// Landing point for a task function that returns
+static void OS_TaskExit(void) {
+    uint32_t basepri = NVIC_EnterCritical();
+    OS_Task_t *pTask = g_os_current;
+
+    g_os_ready &= ~OS_PRIO_BIT(pTask->Priority);
+    g_os_tasks[pTask->Priority] = 0;
+    pTask->State = OS_TASK_DORMANT;
+    OS_Schedule();
+    NVIC_ExitCritical(basepri);
+
+    while (1) {
+    }
+}
+
+// Helper to build the initial stack frame and register the task
+static void OS_TaskSetup(OS_Task_t *pTask, void (*pfnEntry)(void *pArg), void *pArg,
+                         uint32_t *pStack, uint32_t StackWords, uint8_t Priority) {
+    uint32_t *sp = (uint32_t *)((uint32_t)(pStack + StackWords) & ~7U); // AAPCS: 8-byte aligned
+    uint32_t i;
+
+    // Hardware frame popped on exception return
+    *--sp = 0x01000000U;                            // xPSR: Thumb
+    *--sp = (uint32_t)pfnEntry & ~1U;               // PC
+    *--sp = (uint32_t)OS_TaskExit;                  // LR
+    *--sp = 0;                                      // R12
+    *--sp = 0;                                      // R3
+    *--sp = 0;                                      // R2
+    *--sp = 0;                                      // R1
+    *--sp = (uint32_t)pArg;                         // R0
+    // R4-R11, restored by PendSV/SVC
+    for (i = 0; i < 8U; i++) {
+        *--sp = 0;
+    }
+
+    pTask->pSP = sp;
+    pTask->DelayTicks = 0;
+    pTask->pWaitMask = 0;
+    pTask->pWaitData = 0;
+    pTask->WaitResult = OS_OK;
+    pTask->Priority = Priority;
+    pTask->State = OS_TASK_READY;
+
+    g_os_tasks[Priority] = pTask;
+    g_os_ready |= OS_PRIO_BIT(Priority);
+}
+
+static void OS_IdleTask(void *pArg) {
+    (void)pArg;
+    while (1) {
+        OS_IdleHook();
+    }
+}
+
+/**
+ * @brief  Creates a task. May be called before or after OS_Start.
+ * @param  pTask: caller-owned control block
+ * @param  pfnEntry: task function; returning from it ends the task
+ * @param  pArg: passed to pfnEntry
+ * @param  pStack: caller-owned stack (at least OS_MIN_STACK_WORDS words)
+ * @param  StackWords: size of pStack in 32-bit words
+ * @param  Priority: 0 (highest) .. OS_PRIO_IDLE - 1, one task per level
+ * @return OS_OK, OS_ERROR_PARAM or OS_ERROR_PRIO_USED
+ */
+OS_Status OS_TaskCreate(OS_Task_t *pTask, void (*pfnEntry)(void *pArg), void *pArg,
+                        uint32_t *pStack, uint32_t StackWords, uint8_t Priority) {
+    uint32_t basepri;
+
+    if (pTask == 0 || pfnEntry == 0 || pStack == 0 || StackWords < OS_MIN_STACK_WORDS || Priority >= OS_PRIO_IDLE) {
+        return OS_ERROR_PARAM;
+    }
+
+    basepri = NVIC_EnterCritical();
+    if (g_os_tasks[Priority] != 0) {
+        NVIC_ExitCritical(basepri);
+        return OS_ERROR_PRIO_USED;
+    }
+    OS_TaskSetup(pTask, pfnEntry, pArg, pStack, StackWords, Priority);
+    OS_Schedule();
+    NVIC_ExitCritical(basepri);
+    return OS_OK;
+}
+
+/**
+ * @brief  Starts scheduling with the highest-priority ready task. Never returns.
+ *         SysTick_Init must have been called; OS_Tick runs from its interrupt.
+ */
+void OS_Start(void) {
+    __asm volatile ("cpsid i" ::: "memory");
+
+    OS_TaskSetup(&g_os_idle_task, OS_IdleTask, 0, g_os_idle_stack, OS_IDLE_STACK_WORDS, OS_PRIO_IDLE);
+
+    // PendSV and SysTick at the lowest priority: a switch never preempts an ISR
+    SCB->SHP[10] = 0xF0;    // PendSV (exception 14)
+    SCB->SHP[11] = 0xF0;    // SysTick (exception 15)
+
+    g_os_current = g_os_tasks[__builtin_clz(g_os_ready)];
+    g_os_next = g_os_current;
+    g_os_running = 1;
+
+    // SVC needs interrupts enabled, otherwise it escalates to HardFault
+    __asm volatile ("cpsie i\n\tsvc 0" ::: "memory");
+
+    while (1) {
+    }
+}
+
+/**
+ * @brief  Suspends the calling task for a number of ticks (ms)
+ * @param  Ticks: delay; 0 returns immediately
+ */
+void OS_Delay(uint32_t Ticks) {
+    uint32_t basepri;
+    OS_Task_t *pTask;
+    uint32_t bit;
+
+    if (Ticks == 0) {
+        return;
+    }
+
+    basepri = NVIC_EnterCritical();
+    pTask = g_os_current;
+    bit = OS_PRIO_BIT(pTask->Priority);
+    g_os_ready &= ~bit;
+    g_os_delayed |= bit;
+    pTask->DelayTicks = Ticks;
+    pTask->State = OS_TASK_DELAYED;
+    OS_Schedule();
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Task currently running (0 before OS_Start)
+ */
+OS_Task_t *OS_GetCurrentTask(void) {
+    return g_os_current;
+}
+
+/**
+ * @brief  Checks whether OS_Start has been called
+ */
+uint8_t OS_IsRunning(void) {
+    return g_os_running;
+}
+
+/**
+ * @brief  Advances delays and wait timeouts by one tick. Called from the
+ *         SysTick interrupt (see SysTick_Callback below).
+ */
+void OS_Tick(void) {
+    uint32_t basepri;
+    uint32_t pending;
+
+    if (!g_os_running) {
+        return;
+    }
+
+    basepri = NVIC_EnterCritical();
+    pending = g_os_delayed;
+    while (pending) {
+        uint32_t prio = (uint32_t)__builtin_clz(pending);
+        uint32_t bit = OS_PRIO_BIT(prio);
+        OS_Task_t *pTask = g_os_tasks[prio];
+
+        pending &= ~bit;
+        if (--pTask->DelayTicks == 0) {
+            g_os_delayed &= ~bit;
+            if (pTask->pWaitMask) {
+                // Wait timed out: leave the object's wait list
+                *pTask->pWaitMask &= ~bit;
+                pTask->pWaitMask = 0;
+                pTask->WaitResult = OS_TIMEOUT;
+            }
+            pTask->State = OS_TASK_READY;
+            g_os_ready |= bit;
+        }
+    }
+    OS_Schedule();
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Initializes a counting semaphore
+ */
+void OS_SemInit(OS_Sem_t *pSem, uint32_t InitialCount) {
+    pSem->Count = InitialCount;
+    pSem->WaitMask = 0;
+}
+
+/**
+ * @brief  Takes a semaphore, blocking up to Timeout ticks
+ * @return OS_OK or OS_TIMEOUT
+ */
+OS_Status OS_SemTake(OS_Sem_t *pSem, uint32_t Timeout) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pSem->Count > 0) {
+        pSem->Count--;
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (Timeout == OS_NO_WAIT) {
+        NVIC_ExitCritical(basepri);
+        return OS_TIMEOUT;
+    }
+    return OS_Block(&pSem->WaitMask, Timeout, basepri);
+}
+
+/**
+ * @brief  Gives a semaphore. Safe from interrupts: the highest-priority
+ *         waiter is made ready directly and runs when the ISR returns.
+ */
+void OS_SemGive(OS_Sem_t *pSem) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pSem->WaitMask) {
+        (void)OS_WakeOne(&pSem->WaitMask, OS_OK);
+        OS_Schedule();
+    } else {
+        pSem->Count++;
+    }
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Initializes a mutex (unlocked)
+ */
+void OS_MutexInit(OS_Mutex_t *pMutex) {
+    pMutex->pOwner = 0;
+    pMutex->Nesting = 0;
+    pMutex->WaitMask = 0;
+}
+
+/**
+ * @brief  Locks a mutex, blocking up to Timeout ticks. Task context only;
+ *         the owner may lock again (recursive).
+ * @return OS_OK or OS_TIMEOUT
+ */
+OS_Status OS_MutexLock(OS_Mutex_t *pMutex, uint32_t Timeout) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pMutex->pOwner == 0) {
+        pMutex->pOwner = g_os_current;
+        pMutex->Nesting = 1;
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (pMutex->pOwner == g_os_current) {
+        pMutex->Nesting++;
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (Timeout == OS_NO_WAIT) {
+        NVIC_ExitCritical(basepri);
+        return OS_TIMEOUT;
+    }
+    // Ownership is handed over by OS_MutexUnlock
+    return OS_Block(&pMutex->WaitMask, Timeout, basepri);
+}
+
+/**
+ * @brief  Unlocks a mutex; the highest-priority waiter becomes the owner
+ * @return OS_OK or OS_ERROR_NOT_OWNER
+ */
+OS_Status OS_MutexUnlock(OS_Mutex_t *pMutex) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pMutex->pOwner != g_os_current) {
+        NVIC_ExitCritical(basepri);
+        return OS_ERROR_NOT_OWNER;
+    }
+    if (--pMutex->Nesting == 0) {
+        if (pMutex->WaitMask) {
+            pMutex->pOwner = OS_WakeOne(&pMutex->WaitMask, OS_OK);
+            pMutex->Nesting = 1;
+            OS_Schedule();
+        } else {
+            pMutex->pOwner = 0;
+        }
+    }
+    NVIC_ExitCritical(basepri);
+    return OS_OK;
+}
+
+/**
+ * @brief  Initializes a message queue
+ * @param  pQueue: queue object
+ * @param  pBuffer: storage for Capacity items of ItemSize bytes
+ * @param  ItemSize: bytes per item
+ * @param  Capacity: items; 0 makes every send wait for a receiver
+ */
+void OS_QueueInit(OS_Queue_t *pQueue, void *pBuffer, uint16_t ItemSize, uint16_t Capacity) {
+    pQueue->pBuffer = (uint8_t *)pBuffer;
+    pQueue->ItemSize = ItemSize;
+    pQueue->Capacity = Capacity;
+    pQueue->Head = 0;
+    pQueue->Tail = 0;
+    pQueue->Count = 0;
+    pQueue->RecvWaitMask = 0;
+    pQueue->SendWaitMask = 0;
+}
+
+/**
+ * @brief  Sends one item (copied). A waiting receiver gets it directly.
+ * @param  Timeout: ticks to wait for space; use OS_NO_WAIT from interrupts
+ * @return OS_OK or OS_TIMEOUT
+ */
+OS_Status OS_QueueSend(OS_Queue_t *pQueue, const void *pItem, uint32_t Timeout) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pQueue->RecvWaitMask) {
+        OS_Task_t *pTask = OS_WakeOne(&pQueue->RecvWaitMask, OS_OK);
+        OS_CopyItem((uint8_t *)pTask->pWaitData, (const uint8_t *)pItem, pQueue->ItemSize);
+        OS_Schedule();
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (pQueue->Count < pQueue->Capacity) {
+        OS_CopyItem(&pQueue->pBuffer[pQueue->Head * pQueue->ItemSize], (const uint8_t *)pItem, pQueue->ItemSize);
+        pQueue->Head = (uint16_t)((pQueue->Head + 1U == pQueue->Capacity) ? 0 : pQueue->Head + 1U);
+        pQueue->Count++;
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (Timeout == OS_NO_WAIT) {
+        NVIC_ExitCritical(basepri);
+        return OS_TIMEOUT;
+    }
+    // A receiver copies the item straight from the caller
+    g_os_current->pWaitData = (void *)pItem;
+    return OS_Block(&pQueue->SendWaitMask, Timeout, basepri);
+}
+
+/**
+ * @brief  Receives one item (copied out)
+ * @param  Timeout: ticks to wait for an item; use OS_NO_WAIT from interrupts
+ * @return OS_OK or OS_TIMEOUT
+ */
+OS_Status OS_QueueReceive(OS_Queue_t *pQueue, void *pItem, uint32_t Timeout) {
+    uint32_t basepri = NVIC_EnterCritical();
+    OS_Task_t *pTask;
+
+    if (pQueue->Count > 0) {
+        OS_CopyItem((uint8_t *)pItem, &pQueue->pBuffer[pQueue->Tail * pQueue->ItemSize], pQueue->ItemSize);
+        pQueue->Tail = (uint16_t)((pQueue->Tail + 1U == pQueue->Capacity) ? 0 : pQueue->Tail + 1U);
+        pQueue->Count--;
+
+        // Refill the freed slot from the highest-priority blocked sender
+        if (pQueue->SendWaitMask) {
+            pTask = OS_WakeOne(&pQueue->SendWaitMask, OS_OK);
+            OS_CopyItem(&pQueue->pBuffer[pQueue->Head * pQueue->ItemSize], (const uint8_t *)pTask->pWaitData, pQueue->ItemSize);
+            pQueue->Head = (uint16_t)((pQueue->Head + 1U == pQueue->Capacity) ? 0 : pQueue->Head + 1U);
+            pQueue->Count++;
+            OS_Schedule();
+        }
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (pQueue->SendWaitMask) {
+        // Zero-capacity queue: take the item from the sender itself
+        pTask = OS_WakeOne(&pQueue->SendWaitMask, OS_OK);
+        OS_CopyItem((uint8_t *)pItem, (const uint8_t *)pTask->pWaitData, pQueue->ItemSize);
+        OS_Schedule();
+        NVIC_ExitCritical(basepri);
+        return OS_OK;
+    }
+    if (Timeout == OS_NO_WAIT) {
+        NVIC_ExitCritical(basepri);
+        return OS_TIMEOUT;
+    }
+    g_os_current->pWaitData = pItem;
+    return OS_Block(&pQueue->RecvWaitMask, Timeout, basepri);
+}
+
+__attribute__((weak)) void OS_IdleHook(void) {
+    __asm volatile ("wfi");
+}
+
+/**
+ * @brief  Installs the function PendSV runs before the context switch
+ *         (WQ_Init installs WQ_Run). Used by the default PendSV_Callback.
+ * @param  pfnHook: hook, 0 for none
+ */
+void OS_SetPendSVHook(OS_Hook_t pfnHook) {
+    g_os_pendsv_hook = pfnHook;
+}
+
+/*
+ * Default PendSV hook: the installed function, if any. An application that
+ * overrides it takes over the deferred work and must call WQ_Run itself.
+ */
+__attribute__((weak)) void PendSV_Callback(void) {
+    OS_Hook_t pfnHook = g_os_pendsv_hook;
+
+    if (pfnHook != 0) {
+        pfnHook();
+    }
+}
+
+/**
+ * @brief  Kernel tick, overrides the weak hook called by the SysTick handler
+ */
+void SysTick_Callback(void) {
+    OS_Tick();
+}
+
+/**
+ * @brief  SVC exception: launches the first task (svc 0 from OS_Start).
+ *         Restores R4-R11 from its stack, switches thread mode to PSP and
+ *         lets the exception return pop the rest of the frame.
+ */
+__attribute__((naked)) void v_v_svc_handler(void) {
+    __asm volatile (
+        "ldr    r3, =g_os_current       \n"
+        "ldr    r1, [r3]                \n"
+        "ldr    r0, [r1]                \n"     // pSP
+        "ldmia  r0!, {r4-r11}           \n"
+        "msr    psp, r0                 \n"
+        "isb                            \n"
+        "ldr    lr, =0xFFFFFFFD         \n"     // Thread mode, PSP
+        "bx     lr                      \n"
+        ".ltorg                         \n"
+    );
+}
+
+/**
+ * @brief  PendSV exception: runs PendSV_Callback (deferred work), then
+ *         saves R4-R11 of g_os_current on its PSP and resumes g_os_next.
+ *         The hardware frame (R0-R3, R12, LR, PC, xPSR) is stacked/unstacked
+ *         by the exception entry and return.
+ */
+__attribute__((naked)) void v_v_pendsv_handler(void) {
+    __asm volatile (
+        "push   {r4, lr}                \n"     // EXC_RETURN; r4 keeps MSP 8-byte aligned
+        "bl     PendSV_Callback         \n"
+        "pop    {r4, lr}                \n"
+        "ldr    r3, =g_os_current       \n"
+        "ldr    r2, [r3]                \n"
+        "ldr    r1, =g_os_next          \n"
+        "ldr    r1, [r1]                \n"
+        "cmp    r1, r2                  \n"
+        "beq    1f                      \n"     // Nothing to switch
+        "mrs    r0, psp                 \n"
+        "stmdb  r0!, {r4-r11}           \n"
+        "str    r0, [r2]                \n"     // current->pSP
+        "str    r1, [r3]                \n"     // current = next
+        "ldr    r0, [r1]                \n"
+        "ldmia  r0!, {r4-r11}           \n"
+        "msr    psp, r0                 \n"
+        "1:                             \n"
+        "bx     lr                      \n"
+        ".ltorg                         \n"
+    );
+}
@@ -0,0 +1,154 @@
+#include "lowpower.h"
+#include "systick.h"
+#include "rtc.h"
+#include "rcc.h"
+#include "dwt.h"
+#include "swtimer.h"
+
+static uint32_t g_rtc_tick_hz = 0;      // 0: STOP mode not available
+static uint32_t g_stats_start_ms = 0;
+static LP_Stats_t g_lp_stats;
+
+// Helper computing Value * Mul / Div in 32-bit arithmetic (the link has no libgcc for 64-bit division)
+static uint32_t LP_Scale(uint32_t Value, uint32_t Mul, uint32_t Div) {
+    return ((Value / Div) * Mul) + (((Value % Div) * Mul) / Div);
+}
+
+/**
+ * @brief  Initializes the idle manager
+ * @param  RtcTickHz: rate the application runs the RTC counter at
+ *         (e.g. 1024 for LSE/32), or 0 to never use STOP mode. The RTC
+ *         itself must already be clocked and configured.
+ */
+void LP_Init(uint32_t RtcTickHz) {
+    g_rtc_tick_hz = RtcTickHz;
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+
+    if (RtcTickHz != 0) {
+        // RTC alarm as a wakeup event (EXTI17, event mode: no ISR needed)
+        EXTI->EMR |= EXTI_LINE_RTC_ALARM;
+        EXTI->RTSR |= EXTI_LINE_RTC_ALARM;
+    }
+    LP_ResetStats();
+}
+
+/**
+ * @brief  Puts the core to sleep until the next deadline or interrupt. The
+ *         deadline is the earlier of the next software timer event
+ *         (SWT_NextDeadline) and MaxMs.
+ * @param  MaxMs: the caller's own bound, for example the smallest
+ *         timeout_remaining of its timeout_t (these are not registered
+ *         anywhere), or LP_IDLE_FOREVER
+ */
+void LP_Idle(uint32_t MaxMs) {
+    uint32_t idle_ms = SWT_NextDeadline();
+
+    if (MaxMs < idle_ms) {
+        idle_ms = MaxMs;
+    }
+    if (idle_ms == 0) {
+        return;
+    }
+    if (g_rtc_tick_hz != 0 && idle_ms >= LP_STOP_MIN_MS) {
+        LP_Stop(idle_ms);
+    } else {
+        LP_Sleep(idle_ms);
+    }
+}
+
+/**
+ * @brief  Sleep mode (WFI) with a single SysTick wakeup after IdleMs
+ * @param  IdleMs: upper bound of the sleep; any interrupt ends it earlier
+ */
+void LP_Sleep(uint32_t IdleMs) {
+    uint32_t cycles = SysTick_TicklessSleep(IdleMs);
+
+    g_lp_stats.SleepUs += cycles_to_us(cycles);
+    g_lp_stats.SleepCount++;
+}
+
+/**
+ * @brief  STOP mode with the RTC alarm as the wakeup. HSE/PLL stop, so the
+ *         clock profile in use is restored (and drivers re-tuned through the
+ *         RCC notifiers) before returning. millis() and the software timer
+ *         wheel are moved on by the time the RTC counted.
+ * @param  IdleMs: upper bound of the stop; EXTI lines also wake the core
+ */
+void LP_Stop(uint32_t IdleMs) {
+    uint8_t profile = RCC_GetClockProfile();
+    uint32_t rtc_ticks, start, elapsed_ms;
+
+    if (IdleMs > LP_STOP_MAX_MS) {
+        IdleMs = LP_STOP_MAX_MS;
+    }
+    rtc_ticks = (g_rtc_tick_hz != 0) ? LP_Scale(IdleMs, g_rtc_tick_hz, 1000U) : 0;
+    if (rtc_ticks < 2U) {
+        LP_Sleep(IdleMs);
+        return;
+    }
+
+    __asm volatile ("cpsid i" ::: "memory");
+
+    // Alarm at start + rtc_ticks
+    RTC_WaitForSynchro();
+    start = RTC_GetCounter();
+    RTC_WaitForLastTask();
+    RTC_ClearFlag(RTC_FLAG_ALR);
+    RTC_SetAlarm(start + rtc_ticks);
+    RTC_WaitForLastTask();
+    EXTI->PR = EXTI_LINE_RTC_ALARM;
+
+    SysTick_Suspend();
+
+    // Regulator in low-power mode, STOP rather than STANDBY
+    PWR->CR &= ~PWR_CR_PDDS;
+    PWR->CR |= PWR_CR_LPDS | PWR_CR_CWUF;
+    // SEVONPEND: pending interrupts wake WFE even with PRIMASK set
+    SCB->SCR |= SCB_SCR_SLEEPDEEP | SCB_SCR_SEVONPEND;
+
+    // SEV + WFE clears a stale event, the second WFE really sleeps
+    __asm volatile ("sev\n\twfe\n\twfe" ::: "memory");
+
+    SCB->SCR &= ~(SCB_SCR_SLEEPDEEP | SCB_SCR_SEVONPEND);
+
+    // Running on HSI now: bring the previous clocks back
+    (void)RCC_ClockSwitch(profile);
+
+    RTC_WaitForSynchro();
+    elapsed_ms = LP_Scale(RTC_GetCounter() - start, 1000U, g_rtc_tick_hz);
+    EXTI->PR = EXTI_LINE_RTC_ALARM;
+    RTC_ClearFlag(RTC_FLAG_ALR);
+
+    SysTick_Resume(elapsed_ms);
+    g_lp_stats.StopUs += (uint64_t)elapsed_ms * 1000U;
+    g_lp_stats.StopCount++;
+
+    __asm volatile ("cpsie i" ::: "memory");
+
+    // The wheel's timer was gated too; its due callbacks run from here
+    SWT_CatchUp(elapsed_ms);
+}
+
+/**
+ * @brief  Snapshot of the sleep counters
+ * @param  pStats: filled in; ActiveUs is derived from millis()
+ */
+void LP_GetStats(LP_Stats_t *pStats) {
+    uint64_t total_us = (uint64_t)(millis() - g_stats_start_ms) * 1000U;
+    uint64_t asleep_us = g_lp_stats.SleepUs + g_lp_stats.StopUs;
+
+    *pStats = g_lp_stats;
+    pStats->ActiveUs = (total_us > asleep_us) ? (total_us - asleep_us) : 0;
+}
+
+/**
+ * @brief  Clears the sleep counters and restarts the measurement window
+ */
+void LP_ResetStats(void) {
+    g_lp_stats.SleepUs = 0;
+    g_lp_stats.StopUs = 0;
+    g_lp_stats.ActiveUs = 0;
+    g_lp_stats.SleepCount = 0;
+    g_lp_stats.StopCount = 0;
+    g_stats_start_ms = millis();
+}
@@ -0,0 +1,133 @@
+#include "nvic.h"
+
+#ifdef NVIC_RAM_VECTORS
+// Flash table from the startup file, and its RAM copy placed by the linker script
+extern const uint32_t v_v_vector_table[NVIC_VECTOR_COUNT];
+static volatile uint32_t g_ram_vectors[NVIC_VECTOR_COUNT] __attribute__((section(".ram_vectors"), aligned(512)));
+#endif
+
+/**
+ * @brief  Selects how the 4 priority bits split into preemption and
+ *         sub-priority (AIRCR.PRIGROUP). Call once, before setting priorities.
+ * @param  PriorityGroup: @ref NVIC_Priority_Group
+ */
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup) {
+    uint32_t aircr = SCB->AIRCR;
+
+    // Writes are ignored unless VECTKEY accompanies them
+    aircr &= ~(0xFFFFUL << 16) & ~SCB_AIRCR_PRIGROUP_Msk;
+    aircr |= SCB_AIRCR_VECTKEY | ((PriorityGroup & 7U) << SCB_AIRCR_PRIGROUP_Pos);
+    SCB->AIRCR = aircr;
+}
+
+/**
+ * @brief  Returns the current AIRCR.PRIGROUP value (@ref NVIC_Priority_Group)
+ */
+uint32_t NVIC_GetPriorityGrouping(void) {
+    return (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk) >> SCB_AIRCR_PRIGROUP_Pos;
+}
+
+/**
+ * @brief  Builds a 4-bit priority for NVIC_SetPriority from preemption and
+ *         sub-priority under the current grouping. Out-of-range parts are
+ *         truncated to the bits available.
+ */
+uint8_t NVIC_EncodePriority(uint8_t PreemptPriority, uint8_t SubPriority) {
+    uint32_t group = NVIC_GetPriorityGrouping();
+    uint32_t preempt_bits;
+    uint32_t sub_bits;
+
+    if (group < (7U - NVIC_PRIO_BITS)) {
+        group = 7U - NVIC_PRIO_BITS;
+    }
+    preempt_bits = 7U - group;
+    sub_bits = NVIC_PRIO_BITS - preempt_bits;
+
+    return (uint8_t)(((PreemptPriority & ((1U << preempt_bits) - 1U)) << sub_bits) |
+                     (SubPriority & ((1U << sub_bits) - 1U)));
+}
+
+/**
+ * @brief  Enables an interrupt in the NVIC
+ * @param  IRQNumber: IRQ_NO_x
+ */
+void NVIC_EnableIRQ(uint8_t IRQNumber) {
+    // Set/clear registers: writing zeros has no effect, so no read-modify-write
+    NVIC->ISER[IRQNumber >> 5] = 1UL << (IRQNumber & 31U);
+}
+
+/**
+ * @brief  Disables an interrupt in the NVIC. The barriers make sure it can
+ *         no longer fire once this returns.
+ * @param  IRQNumber: IRQ_NO_x
+ */
+void NVIC_DisableIRQ(uint8_t IRQNumber) {
+    NVIC->ICER[IRQNumber >> 5] = 1UL << (IRQNumber & 31U);
+    __asm volatile ("dsb\n\tisb" ::: "memory");
+}
+
+uint8_t NVIC_IsEnabled(uint8_t IRQNumber) {
+    return (uint8_t)((NVIC->ISER[IRQNumber >> 5] >> (IRQNumber & 31U)) & 1U);
+}
+
+void NVIC_SetPending(uint8_t IRQNumber) {
+    NVIC->ISPR[IRQNumber >> 5] = 1UL << (IRQNumber & 31U);
+}
+
+void NVIC_ClearPending(uint8_t IRQNumber) {
+    NVIC->ICPR[IRQNumber >> 5] = 1UL << (IRQNumber & 31U);
+}
+
+uint8_t NVIC_IsPending(uint8_t IRQNumber) {
+    return (uint8_t)((NVIC->ISPR[IRQNumber >> 5] >> (IRQNumber & 31U)) & 1U);
+}
+
+uint8_t NVIC_IsActive(uint8_t IRQNumber) {
+    return (uint8_t)((NVIC->IABR[IRQNumber >> 5] >> (IRQNumber & 31U)) & 1U);
+}
+
+/**
+ * @brief  Sets the priority of an interrupt; lower values preempt higher ones.
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  Priority: 0..15 (see NVIC_EncodePriority when grouping is used)
+ */
+void NVIC_SetPriority(uint8_t IRQNumber, uint8_t Priority) {
+    // One byte per IRQ, only the upper NVIC_PRIO_BITS are implemented
+    NVIC->IP[IRQNumber] = (uint8_t)((Priority & NVIC_PRIORITY_LOWEST) << (8U - NVIC_PRIO_BITS));
+}
+
+uint8_t NVIC_GetPriority(uint8_t IRQNumber) {
+    return (uint8_t)(NVIC->IP[IRQNumber] >> (8U - NVIC_PRIO_BITS));
+}
+
+#ifdef NVIC_RAM_VECTORS
+/**
+ * @brief  Copies the flash vector table to SRAM and points VTOR at the copy.
+ *         Entries are identical at the switch, so interrupts may stay enabled.
+ */
+void NVIC_RelocateVectorTable(void) {
+    for (uint32_t i = 0; i < NVIC_VECTOR_COUNT; i++) {
+        g_ram_vectors[i] = v_v_vector_table[i];
+    }
+    __asm volatile ("dsb" ::: "memory");
+    SCB->VTOR = (uint32_t)g_ram_vectors;
+    __asm volatile ("dsb\n\tisb" ::: "memory");
+}
+
+/**
+ * @brief  Installs a handler directly in the SRAM vector table, so it is
+ *         entered with no dispatch indirection.
+ *         NVIC_RelocateVectorTable must have been called.
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  pfnHandler: plain void(void) function (Thumb address)
+ */
+void NVIC_SetVector(uint8_t IRQNumber, NVIC_Handler_t pfnHandler) {
+    g_ram_vectors[16U + IRQNumber] = (uint32_t)pfnHandler;
+    // The next exception entry must fetch the new entry
+    __asm volatile ("dsb" ::: "memory");
+}
+
+NVIC_Handler_t NVIC_GetVector(uint8_t IRQNumber) {
+    return (NVIC_Handler_t)g_ram_vectors[16U + IRQNumber];
+}
+#endif
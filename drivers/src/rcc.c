@@ -1,20 +1,120 @@
 #include "rcc.h"
+#include "dwt.h"
+
+/* Decoded once per clock change, read by every driver */
+static RCC_Clocks_t g_rcc_clocks;
+static uint8_t g_rcc_clocks_valid = 0;
+
+static const uint8_t APBAHBPrescTable[16] = {0, 0, 0, 0, 1, 2, 3, 4, 1, 2, 3, 4, 6, 7, 8, 9};
+static const uint8_t ADCPrescTable[4] = {2, 4, 6, 8};
+
+/* PLL multiplier for each profile (0 = no PLL) */
+static const uint8_t ClockProfilePllMul[4] = {0, 3, 6, 9};
+
+/* Registered clock change listeners */
+static RCC_ClockNotifier_t *g_clock_notifiers = 0;
+static uint32_t g_last_switch_cycles = 0;
+static uint8_t g_clock_profile = RCC_CLOCK_HSI_8MHZ;  // Reset state
+
+// Helper to call every registered listener
+static void RCC_NotifyClockChange(uint8_t Event) {
+    RCC_ClockNotifier_t *pNotifier;
+    for (pNotifier = g_clock_notifiers; pNotifier != 0; pNotifier = pNotifier->pNext) {
+        pNotifier->pfnNotify(Event, &g_rcc_clocks, pNotifier->pContext);
+    }
+}
+
+// Helper to program the Flash wait states for a given HCLK (RM0008 3.3.3)
+static void RCC_SetFlashLatency(uint32_t hclk) {
+    uint32_t tmpreg = FLASH->ACR & ~FLASH_ACR_LATENCY_Msk;
+
+    if (hclk <= 24000000U) {
+        tmpreg |= FLASH_ACR_LATENCY_0;
+    } else if (hclk <= 48000000U) {
+        tmpreg |= FLASH_ACR_LATENCY_1;
+    } else {
+        tmpreg |= FLASH_ACR_LATENCY_2;
+    }
+    FLASH->ACR = tmpreg | FLASH_ACR_PRFTBE;
+}
+
+// Helper to bounded-wait for a condition on an RCC register
+static uint8_t RCC_WaitFlag(volatile uint32_t *pReg, uint32_t Mask, uint32_t Value) {
+    volatile uint32_t timeout = 0;
+    while ((*pReg & Mask) != Value) {
+        timeout++;
+        if (timeout > 100000) return 0;
+    }
+    return 1;
+}
+
+// Helper to move SYSCLK to HSE x pllmul (HSI when pllmul is 0); touches registers only, no RAM state
+static RCC_Status RCC_ProgramClocks(uint32_t pllmul) {
+    RCC_Status status = RCC_OK;
+    uint32_t tmpreg;
+
+    // 2. Park on HSI so the PLL can be reprogrammed
+    RCC->CR |= RCC_CR_HSION;
+    (void)RCC_WaitFlag(&RCC->CR, RCC_CR_HSIRDY, RCC_CR_HSIRDY);
+    RCC->CFGR &= ~RCC_CFGR_SW_Msk; // SW = HSI
+    (void)RCC_WaitFlag(&RCC->CFGR, RCC_CFGR_SWS_Msk, RCC_CFGR_SWS_HSI);
+    RCC->CR &= ~RCC_CR_PLLON;
+    (void)RCC_WaitFlag(&RCC->CR, RCC_CR_PLLRDY, 0);
+
+    // 3. Bus prescalers: AHB = 1, APB2 = 1, APB1 = 2 above 36MHz
+    tmpreg = RCC->CFGR;
+    tmpreg &= ~(RCC_CFGR_HPRE_Msk | RCC_CFGR_PPRE1_Msk | RCC_CFGR_PPRE2_Msk);
+    tmpreg |= RCC_CFGR_HPRE_DIV1 | RCC_CFGR_PPRE2_DIV1;
+    tmpreg |= (pllmul * HSE_VALUE > 36000000U) ? RCC_CFGR_PPRE1_DIV2 : RCC_CFGR_PPRE1_DIV1;
+    RCC->CFGR = tmpreg;
+
+    if (pllmul == 0) {
+        // HSI only: the crystal is not needed any more
+        RCC->CR &= ~RCC_CR_HSEON;
+    } else {
+        // 4. HSE -> PLL -> SYSCLK
+        RCC->CR |= RCC_CR_HSEON;
+        if (!RCC_WaitFlag(&RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY)) {
+            status = RCC_ERROR_HSE;
+        } else {
+            tmpreg = RCC->CFGR;
+            tmpreg &= ~(RCC_CFGR_PLLMULL_Msk | RCC_CFGR_PLLXTPRE);
+            tmpreg |= RCC_CFGR_PLLSRC | ((pllmul - 2U) << RCC_CFGR_PLLMULL_Pos);
+            RCC->CFGR = tmpreg;
+
+            RCC->CR |= RCC_CR_PLLON;
+            if (!RCC_WaitFlag(&RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY)) {
+                status = RCC_ERROR_PLL;
+            } else {
+                RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW_Msk) | RCC_CFGR_SW_PLL;
+                if (!RCC_WaitFlag(&RCC->CFGR, RCC_CFGR_SWS_Msk, RCC_CFGR_SWS_PLL)) {
+                    status = RCC_ERROR_PLL;
+                }
+            }
+        }
+
+        if (status != RCC_OK) {
+            // Stay on HSI with APB1 undivided
+            RCC->CFGR &= ~(RCC_CFGR_SW_Msk | RCC_CFGR_PPRE1_Msk);
+            RCC->CR &= ~(RCC_CR_PLLON | RCC_CR_HSEON);
+        }
+    }
+
+    return status;
+}
 
 /*********************************************************************
  * @fn      		  - SystemClock_Config
  *
  * @brief             - Configures the system clock to 72MHz using HSE and PLL.
  *
- * @details           - This function performs the following steps:
- *                      1. Enables the High-Speed External (HSE) oscillator.
- *                      2. Waits for the HSE to become stable.
- *                      3. Configures the Flash prefetch buffer and latency for high-speed operation.
- *                      4. Configures the AHB, APB1, and APB2 bus prescalers.
- *                      5. Configures the PLL (Phase-Locked Loop) to multiply the HSE frequency (8MHz * 9 = 72MHz).
- *                      6. Enables the PLL.
- *                      7. Waits for the PLL to lock.
- *                      8. Selects the PLL as the system clock source.
- *                      9. Waits for the system clock to switch to the PLL.
+ * @details           - Equivalent to RCC_ClockSwitch(RCC_CLOCK_PLL_72MHZ):
+ *                      HSE x9 through the PLL, Flash prefetch and two wait states,
+ *                      AHB = SYSCLK, APB1 = HCLK/2, APB2 = HCLK.
+ *                      If the HSE or the PLL does not come up the system stays on
+ *                      the 8MHz HSI and the cached clock frequencies say so.
+ *                      When SystemInit (reset handler) already runs the PLL at
+ *                      72MHz, only the cached frequencies and profile are refreshed.
  *
  * @param[in]         - None
  *
@@ -24,65 +124,263 @@
  *                    - This is a common setup for "Blue Pill" STM32F103C8T6 boards.
  */
 void SystemClock_Config(void) {
-    volatile uint32_t timeout = 0;
+    uint32_t cfgr = RCC->CFGR;
 
-    // 1. Enable HSE and wait for it to be ready
-    RCC->CR |= RCC_CR_HSEON;
-    
-    timeout = 0;
-    while (!(RCC->CR & RCC_CR_HSERDY)) {
-        timeout++;
-        if (timeout > 100000) {
-            // Handle timeout (e.g., use HSI or error handler)
-            // For now, we just break to avoid infinite loop
-            break; 
-        }
+    // SystemInit normally has the PLL at 72MHz already: only publish it
+    if (((cfgr & RCC_CFGR_SWS_Msk) == RCC_CFGR_SWS_PLL) &&
+        ((cfgr & RCC_CFGR_PLLMULL_Msk) == ((9U - 2U) << RCC_CFGR_PLLMULL_Pos))) {
+        g_clock_profile = RCC_CLOCK_PLL_72MHZ;
+        RCC_UpdateClocksFreq();
+        DWT_Init();
+        return;
+    }
+    (void)RCC_ClockSwitch(RCC_CLOCK_PLL_72MHZ);
+}
+
+/*********************************************************************
+ * @fn      		  - SystemInit
+ *
+ * @brief             - Early clock bring-up, called by the reset handler before
+ *                      .data/.bss are initialised.
+ *
+ * @details           - Same clock tree as SystemClock_Config (HSE x9 = 72MHz,
+ *                      two wait states, APB1 = HCLK/2) so the C runtime init
+ *                      already runs at full speed. Touches registers only: RAM
+ *                      is not initialised yet. On failure it leaves the system on
+ *                      HSI and SystemClock_Config retries with the full switch.
+ *
+ * @param[in]         - None
+ *
+ * @return            - None
+ */
+void SystemInit(void) {
+    RCC_SetFlashLatency(9U * HSE_VALUE);
+    if (RCC_ProgramClocks(9U) != RCC_OK) {
+        RCC_SetFlashLatency(HSI_VALUE);
+    }
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_ClockSwitch
+ *
+ * @brief             - Switches SYSCLK to one of the predefined clock profiles at runtime.
+ *
+ * @details           - 1. Notifies every registered driver (PRE_CHANGE) so it can
+ *                         drain or pause its peripheral.
+ *                      2. Raises the Flash wait states if the target needs more.
+ *                      3. Parks SYSCLK on HSI and stops the PLL.
+ *                      4. Sets APB1 to /2 above 36MHz, starts HSE and the PLL with
+ *                         the new multiplier, switches SYSCLK to it.
+ *                      5. Trims the Flash wait states to the new HCLK, refreshes the
+ *                         cached frequencies and notifies POST_CHANGE.
+ *                      The duration in core cycles is kept for RCC_GetLastSwitchCycles.
+ *
+ * @param[in]         - Profile: a value of @ref RCC_Clock_Profiles
+ *
+ * @return            - RCC_OK, or RCC_ERROR_HSE / RCC_ERROR_PLL when the system
+ *                      fell back to HSI. Drivers are notified in every case.
+ */
+RCC_Status RCC_ClockSwitch(uint8_t Profile) {
+    RCC_Status status;
+    uint32_t pllmul;
+    uint32_t start;
+
+    if (Profile > RCC_CLOCK_PLL_72MHZ) {
+        Profile = RCC_CLOCK_PLL_72MHZ;
+    }
+    pllmul = ClockProfilePllMul[Profile];
+
+    if (!g_rcc_clocks_valid) {
+        RCC_UpdateClocksFreq();
+    }
+    RCC_NotifyClockChange(RCC_CLOCK_EVENT_PRE_CHANGE);
+
+    // Cycle counter for the switch duration, after the drivers have drained
+    DWT_Init();
+    start = cycles_now();
+
+    // 1. Enough wait states for both the old and the new clock while switching
+    if (pllmul * HSE_VALUE > g_rcc_clocks.HCLK_Frequency) {
+        RCC_SetFlashLatency(pllmul * HSE_VALUE);
+    }
+
+    // 2-4. HSI park, bus prescalers, HSE -> PLL -> SYSCLK
+    status = RCC_ProgramClocks(pllmul);
+
+    // 5. Publish the new clock tree and trim the wait states to it
+    g_clock_profile = (status == RCC_OK) ? Profile : RCC_CLOCK_HSI_8MHZ;
+    RCC_UpdateClocksFreq();
+    RCC_SetFlashLatency(g_rcc_clocks.HCLK_Frequency);
+
+    g_last_switch_cycles = cycles_now() - start;
+    RCC_NotifyClockChange(RCC_CLOCK_EVENT_POST_CHANGE);
+
+    return status;
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_GetLastSwitchCycles
+ *
+ * @brief             - Returns how long the last RCC_ClockSwitch took.
+ *
+ * @return            - Core clock cycles (DWT CYCCNT) from the end of the
+ *                      PRE_CHANGE notifiers to the new clocks being published;
+ *                      neither notifier phase is included.
+ *
+ * @Note              - CYCCNT ticks at whatever HCLK is current, so the figure
+ *                      mixes old and new clock cycles.
+ */
+uint32_t RCC_GetLastSwitchCycles(void) {
+    return g_last_switch_cycles;
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_GetClockProfile
+ *
+ * @brief             - Returns the profile the system is running on.
+ *
+ * @return            - A value of @ref RCC_Clock_Profiles; RCC_CLOCK_HSI_8MHZ
+ *                      before the first switch or after a failed one.
+ */
+uint8_t RCC_GetClockProfile(void) {
+    return g_clock_profile;
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_RegisterClockNotifier
+ *
+ * @brief             - Adds a listener called before and after every RCC_ClockSwitch.
+ *
+ * @param[in]         - pNotifier: caller-owned node with pfnNotify and pContext set;
+ *                      it must stay valid (static or global) while registered.
+ *                      Registering the same node twice has no effect.
+ *
+ * @return            - None
+ */
+void RCC_RegisterClockNotifier(RCC_ClockNotifier_t *pNotifier) {
+    RCC_ClockNotifier_t *pIter;
+    for (pIter = g_clock_notifiers; pIter != 0; pIter = pIter->pNext) {
+        if (pIter == pNotifier) return;
     }
+    pNotifier->pNext = g_clock_notifiers;
+    g_clock_notifiers = pNotifier;
+}
 
-    if (RCC->CR & RCC_CR_HSERDY) {
-        // 2. Configure Flash prefetch and latency
-        FLASH->ACR |= FLASH_ACR_PRFTBE;
-        FLASH->ACR &= ~(FLASH_ACR_LATENCY_0 | FLASH_ACR_LATENCY_1 | FLASH_ACR_LATENCY_2); // Clear LATENCY bits
-        FLASH->ACR |= FLASH_ACR_LATENCY_2; // Two wait states
-
-        // 3. Configure bus prescalers
-        // AHB prescaler = 1
-        RCC->CFGR &= ~((1 << 4) | (1 << 5) | (1 << 6) | (1 << 7)); // HPRE = 0xxx (DIV1)
-        
-        // APB1 prescaler = 2
-        RCC->CFGR &= ~((1 << 8) | (1 << 9) | (1 << 10)); // Clear PPRE1
-        RCC->CFGR |= RCC_CFGR_PPRE1_DIV2;
-        
-        // APB2 prescaler = 1
-        RCC->CFGR &= ~((1 << 11) | (1 << 12) | (1 << 13)); // Clear PPRE2 (DIV1)
-
-        // 4. Configure PLL
-        // PLL source = HSE, PLL multiplication factor = 9
-        RCC->CFGR |= RCC_CFGR_PLLSRC; 
-        RCC->CFGR &= ~((1 << 18) | (1 << 19) | (1 << 20) | (1 << 21)); // Clear PLLMUL bits
-        RCC->CFGR |= RCC_CFGR_PLLMULL9;
-
-        // 5. Enable PLL and wait for it to be ready
-        RCC->CR |= RCC_CR_PLLON;
-        
-        timeout = 0;
-        while (!(RCC->CR & RCC_CR_PLLRDY)) {
-            timeout++;
-            if (timeout > 100000) break;
+/*********************************************************************
+ * @fn      		  - RCC_UnregisterClockNotifier
+ *
+ * @brief             - Removes a listener added with RCC_RegisterClockNotifier.
+ *
+ * @param[in]         - pNotifier: node to remove.
+ *
+ * @return            - None
+ */
+void RCC_UnregisterClockNotifier(RCC_ClockNotifier_t *pNotifier) {
+    RCC_ClockNotifier_t **ppIter;
+    for (ppIter = &g_clock_notifiers; *ppIter != 0; ppIter = &(*ppIter)->pNext) {
+        if (*ppIter == pNotifier) {
+            *ppIter = pNotifier->pNext;
+            return;
         }
+    }
+}
 
-        if (RCC->CR & RCC_CR_PLLRDY) {
-            // 6. Select PLL as system clock source and wait for it to be set
-            RCC->CFGR &= ~((1 << 0) | (1 << 1)); // Clear SW bits
-            RCC->CFGR |= RCC_CFGR_SW_PLL;
-            
-            timeout = 0;
-            while ((RCC->CFGR & (0x03 << 2)) != RCC_CFGR_SWS_PLL) {
-                timeout++;
-                if (timeout > 100000) break;
+/*********************************************************************
+ * @fn      		  - RCC_UpdateClocksFreq
+ *
+ * @brief             - Decodes RCC->CFGR into the cached clock frequencies.
+ *
+ * @details           - Must be called after any change to SW, PLLMUL, PLLSRC,
+ *                      PLLXTPRE, HPRE, PPRE1, PPRE2 or ADCPRE. SystemClock_Config
+ *                      and RCC_ADCCLKConfig do this themselves.
+ *
+ * @param[in]         - None
+ *
+ * @return            - None
+ */
+void RCC_UpdateClocksFreq(void) {
+    uint32_t cfgr = RCC->CFGR;
+    uint32_t sysclk;
+    uint32_t presc;
+
+    // 1. SYSCLK from the switch status actually in effect
+    switch (cfgr & RCC_CFGR_SWS_Msk) {
+        case RCC_CFGR_SWS_HSE:
+            sysclk = HSE_VALUE;
+            break;
+        case RCC_CFGR_SWS_PLL: {
+            uint32_t pllmull = ((cfgr & RCC_CFGR_PLLMULL_Msk) >> RCC_CFGR_PLLMULL_Pos) + 2U;
+            uint32_t pllin;
+            if (pllmull > 16U) pllmull = 16U; // 0b1111 is also x16
+            if (!(cfgr & RCC_CFGR_PLLSRC)) {
+                pllin = HSI_VALUE / 2U;
+            } else if (cfgr & RCC_CFGR_PLLXTPRE) {
+                pllin = HSE_VALUE / 2U;
+            } else {
+                pllin = HSE_VALUE;
             }
+            sysclk = pllin * pllmull;
+            break;
         }
+        default:
+            sysclk = HSI_VALUE;
+            break;
     }
+    g_rcc_clocks.SYSCLK_Frequency = sysclk;
+
+    // 2. Bus clocks
+    g_rcc_clocks.HCLK_Frequency = sysclk >> APBAHBPrescTable[(cfgr & RCC_CFGR_HPRE_Msk) >> RCC_CFGR_HPRE_Pos];
+
+    presc = APBAHBPrescTable[(cfgr & RCC_CFGR_PPRE1_Msk) >> RCC_CFGR_PPRE1_Pos];
+    g_rcc_clocks.PCLK1_Frequency = g_rcc_clocks.HCLK_Frequency >> presc;
+    g_rcc_clocks.TIMCLK1_Frequency = (presc == 0) ? g_rcc_clocks.PCLK1_Frequency : (g_rcc_clocks.PCLK1_Frequency * 2U);
+
+    presc = APBAHBPrescTable[(cfgr & RCC_CFGR_PPRE2_Msk) >> RCC_CFGR_PPRE2_Pos];
+    g_rcc_clocks.PCLK2_Frequency = g_rcc_clocks.HCLK_Frequency >> presc;
+    g_rcc_clocks.TIMCLK2_Frequency = (presc == 0) ? g_rcc_clocks.PCLK2_Frequency : (g_rcc_clocks.PCLK2_Frequency * 2U);
+
+    // 3. ADC kernel clock
+    g_rcc_clocks.ADCCLK_Frequency = g_rcc_clocks.PCLK2_Frequency / ADCPrescTable[(cfgr & RCC_CFGR_ADCPRE_Msk) >> RCC_CFGR_ADCPRE_Pos];
+
+    g_rcc_clocks_valid = 1;
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_GetClocksFreq
+ *
+ * @brief             - Returns the cached SYSCLK, HCLK, PCLK1, PCLK2, ADCCLK and
+ *                      timer clock frequencies.
+ *
+ * @param[out]        - RCC_Clocks: pointer to a RCC_Clocks_t structure which will hold
+ *                      the clock frequencies in Hz.
+ *
+ * @return            - None
+ *
+ * @Note              - The registers are only decoded on the first call or after
+ *                      RCC_UpdateClocksFreq; later calls are a plain copy.
+ */
+void RCC_GetClocksFreq(RCC_Clocks_t *RCC_Clocks) {
+    if (!g_rcc_clocks_valid) {
+        RCC_UpdateClocksFreq();
+    }
+    *RCC_Clocks = g_rcc_clocks;
+}
+
+/*********************************************************************
+ * @fn      		  - RCC_ADCCLKConfig
+ *
+ * @brief             - Configures the ADC clock prescaler (ADCCLK = PCLK2 / div).
+ *
+ * @param[in]         - RCC_PCLK2: a value of @ref RCC_ADC_clock_source
+ *
+ * @return            - None
+ */
+void RCC_ADCCLKConfig(uint32_t RCC_PCLK2) {
+    uint32_t tmpreg = RCC->CFGR;
+    tmpreg &= ~RCC_CFGR_ADCPRE_Msk;
+    tmpreg |= RCC_PCLK2;
+    RCC->CFGR = tmpreg;
+    RCC_UpdateClocksFreq();
 }
 
 /*********************************************************************
@@ -1,4 +1,5 @@
 #include "spi.h"
+#include "nvic.h"
 
 /**
  * @brief  Initializes the SPIx peripheral according to the specified 
@@ -80,3 +81,169 @@ uint8_t SPI_GetFlagStatus(SPI_TypeDef* SPIx, uint16_t SPI_FLAG) {
         return RESET;
     }
 }
+
+// Helper to end the transaction in flight: stop both DMA requests, raise CS, report
+static void SPI_DMA_Finish(SPI_Handle_t *pSPIHandle, SPI_Status Status) {
+    SPI_TypeDef *pSPIx = pSPIHandle->pSPIx;
+    SPI_Transfer_t *pXfer = pSPIHandle->pActive;
+    volatile uint32_t timeout = 0;
+
+    // The last RXNE can come up to half a clock before the bus goes idle
+    while (pSPIx->SR & SPI_SR_BSY) {
+        if (++timeout > 1000) break;
+    }
+
+    pSPIx->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    DMA_Cmd(DMA_GetChannel(pSPIHandle->TxChannel), DISABLE);
+    DMA_Cmd(DMA_GetChannel(pSPIHandle->RxChannel), DISABLE);
+    if (pXfer->pCSPort != 0) {
+        pXfer->pCSPort->BSRR = 1UL << pXfer->CSPin;
+    }
+
+    pSPIHandle->pActive = 0;
+    pXfer->Status = Status;
+    if (pXfer->pfnDone != 0) {
+        pXfer->pfnDone(pXfer, pXfer->pContext);
+    }
+}
+
+// RX transfer complete: every item has been clocked both ways
+static RAMFUNC void SPI_DMA_RxComplete(uint8_t Channel, void *pContext) {
+    (void)Channel;
+    SPI_DMA_Finish((SPI_Handle_t *)pContext, SPI_OK);
+}
+
+// TX or RX transfer error: abort the transaction
+static RAMFUNC void SPI_DMA_Error(uint8_t Channel, void *pContext) {
+    SPI_Handle_t *pSPIHandle = (SPI_Handle_t *)pContext;
+    (void)Channel;
+
+    if (pSPIHandle->pActive != 0) {
+        SPI_DMA_Finish(pSPIHandle, SPI_ERROR);
+    }
+}
+
+// Helper to program one direction of a transaction; a 0 buffer means the fixed dummy item
+static void SPI_DMA_SetupChannel(SPI_Handle_t *pSPIHandle, uint8_t Channel, uint32_t Dir,
+                                 void *pBuffer, uint16_t *pDummy, uint16_t Len) {
+    uint8_t wide = (pSPIHandle->pSPIx->CR1 & SPI_CR1_DFF) != 0U;
+    DMA_Init_t dmaInit;
+
+    dmaInit.DMA_PeripheralBaseAddr = (uint32_t)&pSPIHandle->pSPIx->DR;
+    dmaInit.DMA_MemoryBaseAddr = (uint32_t)((pBuffer != 0) ? pBuffer : pDummy);
+    dmaInit.DMA_DIR = Dir;
+    dmaInit.DMA_BufferSize = Len;
+    dmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInit.DMA_MemoryInc = (pBuffer != 0) ? DMA_MemoryInc_Enable : DMA_MemoryInc_Disable;
+    dmaInit.DMA_PeripheralDataSize = wide ? DMA_PeripheralDataSize_HalfWord : DMA_PeripheralDataSize_Byte;
+    dmaInit.DMA_MemoryDataSize = wide ? DMA_MemoryDataSize_HalfWord : DMA_MemoryDataSize_Byte;
+    dmaInit.DMA_Mode = DMA_Mode_Normal;
+    dmaInit.DMA_M2M = DMA_M2M_Disable;
+    if (Dir == DMA_DIR_PeripheralSRC) {
+        // RX ahead of TX so a received item is always read before the next one lands
+        dmaInit.DMA_Priority = DMA_Priority_VeryHigh;
+        dmaInit.DMA_IT = DMA_IT_TC | DMA_IT_TE;
+    } else {
+        dmaInit.DMA_Priority = DMA_Priority_High;
+        dmaInit.DMA_IT = DMA_IT_TE;
+    }
+
+    DMA_Cmd(DMA_GetChannel(Channel), DISABLE);
+    DMA_Init(DMA_GetChannel(Channel), &dmaInit);
+}
+
+/**
+ * @brief  Claims the TX and RX DMA1 channels of SPIx for SPI_TransferDMA.
+ *         SPIx must be configured (SPI_Init) and enabled (SPI_Cmd) as master
+ *         by the caller. The channel interrupts are claimed at
+ *         DMA_IRQ_PRIORITY and must stay at NVIC_CRITICAL_PRIORITY or below:
+ *         the completion path and SPI_TransferDMA share pActive under a
+ *         BASEPRI critical section. SPI1 with SPI_BaudRatePrescaler_4 runs
+ *         at 18 Mbit/s (PCLK2 = 72MHz).
+ * @param  SPIx: SPI1 or SPI2
+ * @return SPI_OK, or SPI_BUSY if another driver holds one of the channels
+ */
+SPI_Status SPI_DMA_Init(SPI_Handle_t *pSPIHandle, SPI_TypeDef *SPIx) {
+    uint8_t spi1 = (SPIx == SPI1);
+
+    pSPIHandle->pSPIx = SPIx;
+    pSPIHandle->pActive = 0;
+    pSPIHandle->TxDummy = SPI_DUMMY_WORD;
+    pSPIHandle->RxChannel = DMA_Claim(spi1 ? DMA_REQ_SPI1_RX : DMA_REQ_SPI2_RX);
+    pSPIHandle->TxChannel = DMA_Claim(spi1 ? DMA_REQ_SPI1_TX : DMA_REQ_SPI2_TX);
+
+    if ((pSPIHandle->RxChannel == DMA_CHANNEL_NONE) || (pSPIHandle->TxChannel == DMA_CHANNEL_NONE)) {
+        SPI_DMA_DeInit(pSPIHandle);
+        return SPI_BUSY;
+    }
+
+    DMA_SetCallbacks(pSPIHandle->RxChannel, 0, SPI_DMA_RxComplete, SPI_DMA_Error, pSPIHandle);
+    DMA_SetCallbacks(pSPIHandle->TxChannel, 0, 0, SPI_DMA_Error, pSPIHandle);
+    return SPI_OK;
+}
+
+/**
+ * @brief  Releases the DMA channels claimed by SPI_DMA_Init
+ */
+void SPI_DMA_DeInit(SPI_Handle_t *pSPIHandle) {
+    pSPIHandle->pSPIx->CR2 &= ~(SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+    DMA_Release(pSPIHandle->RxChannel);
+    DMA_Release(pSPIHandle->TxChannel);
+    pSPIHandle->RxChannel = DMA_CHANNEL_NONE;
+    pSPIHandle->TxChannel = DMA_CHANNEL_NONE;
+}
+
+/**
+ * @brief  Starts a full-duplex transaction: chip select low (BSRR), Len
+ *         items out of pTxBuffer and into pRxBuffer by DMA, chip select
+ *         high, then pfnDone. The CPU is only involved at the start and the
+ *         end.
+ * @param  pXfer: transaction, owned by the driver until pfnDone
+ * @return SPI_OK if started, SPI_BUSY if a transaction is in flight,
+ *         SPI_ERROR if Len is 0 or the channels are not claimed
+ */
+SPI_Status SPI_TransferDMA(SPI_Handle_t *pSPIHandle, SPI_Transfer_t *pXfer) {
+    SPI_TypeDef *pSPIx = pSPIHandle->pSPIx;
+    uint32_t basepri;
+
+    if ((pXfer->Len == 0U) || (pSPIHandle->RxChannel == DMA_CHANNEL_NONE)) {
+        return SPI_ERROR;
+    }
+
+    basepri = NVIC_EnterCritical();
+    if (pSPIHandle->pActive != 0) {
+        NVIC_ExitCritical(basepri);
+        return SPI_BUSY;
+    }
+    pSPIHandle->pActive = pXfer;
+    NVIC_ExitCritical(basepri);
+
+    pXfer->Status = SPI_BUSY;
+    SPI_DMA_SetupChannel(pSPIHandle, pSPIHandle->RxChannel, DMA_DIR_PeripheralSRC,
+                         pXfer->pRxBuffer, &pSPIHandle->RxDummy, pXfer->Len);
+    SPI_DMA_SetupChannel(pSPIHandle, pSPIHandle->TxChannel, DMA_DIR_PeripheralDST,
+                         (void *)pXfer->pTxBuffer, &pSPIHandle->TxDummy, pXfer->Len);
+
+    // Stale data from an earlier polled transfer would shift RX by one item
+    if (pSPIx->SR & SPI_SR_RXNE) {
+        (void)pSPIx->DR;
+    }
+
+    if (pXfer->pCSPort != 0) {
+        pXfer->pCSPort->BSRR = 1UL << (pXfer->CSPin + 16U);
+    }
+
+    // RM0008 25.3.9: RX request, channels, then TX request
+    pSPIx->CR2 |= SPI_CR2_RXDMAEN;
+    DMA_Cmd(DMA_GetChannel(pSPIHandle->RxChannel), ENABLE);
+    DMA_Cmd(DMA_GetChannel(pSPIHandle->TxChannel), ENABLE);
+    pSPIx->CR2 |= SPI_CR2_TXDMAEN;
+    return SPI_OK;
+}
+
+/**
+ * @brief  1 while a transaction is in flight
+ */
+uint8_t SPI_IsBusy(const SPI_Handle_t *pSPIHandle) {
+    return pSPIHandle->pActive != 0;
+}
@@ -0,0 +1,160 @@
+#include "spibus.h"
+#include "nvic.h"
+
+// Helper to make the head of the queue the active request; caller holds the critical section
+static SPIBUS_Request_t *SPIBUS_Pop(SPIBUS_t *pBus) {
+    SPIBUS_Request_t *pReq = pBus->pQueue;
+
+    if (pReq != 0) {
+        pBus->pQueue = pReq->pNext;
+    }
+    pBus->pActive = pReq;
+    return pReq;
+}
+
+// Helper to load the device's CR1 if it is not already there and start the transfer
+static void SPIBUS_Start(SPIBUS_t *pBus, SPIBUS_Request_t *pReq) {
+    const SPIBUS_Device_t *pDevice = pReq->pDevice;
+    SPI_TypeDef *pSPIx = pBus->Spi.pSPIx;
+
+    if (pDevice != pBus->pCurrent) {
+        // DFF may only change with the SPI disabled; the other fields need just an idle bus
+        if ((pSPIx->CR1 ^ pDevice->Cr1) & SPI_CR1_DFF) {
+            pSPIx->CR1 = pDevice->Cr1 & (uint16_t)~SPI_CR1_SPE;
+        }
+        pSPIx->CR1 = pDevice->Cr1;
+        pBus->pCurrent = pDevice;
+        pBus->Switches++;
+    }
+
+    // Only fails for Len 0 or unclaimed channels, both ruled out before queueing
+    (void)SPI_TransferDMA(&pBus->Spi, &pReq->Xfer);
+}
+
+// Transaction finished (chip select already high): start the next one, then report
+static void SPIBUS_Done(SPI_Transfer_t *pXfer, void *pContext) {
+    SPIBUS_t *pBus = (SPIBUS_t *)pContext;
+    SPIBUS_Request_t *pReq = pBus->pActive;
+    SPIBUS_Request_t *pNext;
+    uint32_t basepri;
+
+    basepri = NVIC_EnterCritical();
+    pNext = SPIBUS_Pop(pBus);
+    NVIC_ExitCritical(basepri);
+
+    if (pNext != 0) {
+        SPIBUS_Start(pBus, pNext);
+    }
+
+    pReq->Status = (pXfer->Status == SPI_OK) ? SPIBUS_DONE : SPIBUS_ERROR;
+    pReq->Busy = 0;
+    if (pReq->pfnDone != 0) {
+        pReq->pfnDone(pReq, pReq->pContext);
+    }
+}
+
+/**
+ * @brief  Claims the DMA channels of SPIx for the bus. The SPI clock, its
+ *         pins and the chip-select outputs (idle high) are set up by the
+ *         caller; CR1 is loaded per device. The DMA channel interrupts run
+ *         SPIBUS_Done and must not preempt NVIC_CRITICAL_PRIORITY (the queue
+ *         lock); DMA_Claim leaves them at DMA_IRQ_PRIORITY.
+ * @param  SPIx: SPI1 or SPI2
+ * @return SPIBUS_OK, or SPIBUS_BUSY if a DMA channel is taken
+ */
+SPIBUS_Status SPIBUS_Init(SPIBUS_t *pBus, SPI_TypeDef *SPIx) {
+    pBus->pQueue = 0;
+    pBus->pActive = 0;
+    pBus->pCurrent = 0;
+    pBus->Switches = 0;
+    return (SPI_DMA_Init(&pBus->Spi, SPIx) == SPI_OK) ? SPIBUS_OK : SPIBUS_BUSY;
+}
+
+/**
+ * @brief  Releases the DMA channels and disables the SPI. The bus must be idle.
+ */
+void SPIBUS_DeInit(SPIBUS_t *pBus) {
+    SPI_DMA_DeInit(&pBus->Spi);
+    SPI_Cmd(pBus->Spi.pSPIx, DISABLE);
+    pBus->pCurrent = 0;
+}
+
+/**
+ * @brief  Computes the CR1 word of a device once, as SPI_Init would write it.
+ * @param  pConfig: full-duplex master settings of the device
+ * @param  pCSPort: chip select port, 0 if the client drives it itself
+ * @param  Priority: queue order among clients, 0 first
+ */
+void SPIBUS_DeviceInit(SPIBUS_Device_t *pDevice, const SPI_Config_t *pConfig,
+                       GPIO_RegDef_t *pCSPort, uint8_t CSPin, uint8_t Priority) {
+    pDevice->Cr1 = (uint16_t)(pConfig->SPI_Direction | pConfig->SPI_Mode | pConfig->SPI_DataSize |
+                              pConfig->SPI_CPOL | pConfig->SPI_CPHA | pConfig->SPI_NSS |
+                              pConfig->SPI_BaudRatePrescaler | pConfig->SPI_FirstBit | SPI_CR1_SPE);
+    pDevice->Priority = Priority;
+    pDevice->CSPin = CSPin;
+    pDevice->pCSPort = pCSPort;
+}
+
+/**
+ * @brief  Queues a full-duplex transaction with a device, behind the pending
+ *         ones of the same or a more urgent priority. Starts it right away
+ *         when the bus is idle.
+ * @param  pReq: caller-owned request, not busy
+ * @param  pTxBuffer: data to send, or 0 for dummy items
+ * @param  pRxBuffer: received data, or 0 to discard it
+ * @param  Len: items (bytes, or half-words for a 16-bit device), not 0
+ * @param  pfnDone: called once the transaction is done (or failed), may be 0
+ * @return SPIBUS_OK (queued), SPIBUS_BUSY (pReq still in use) or SPIBUS_ERROR
+ */
+SPIBUS_Status SPIBUS_TransferAsync(SPIBUS_t *pBus, SPIBUS_Request_t *pReq, const SPIBUS_Device_t *pDevice,
+                                   const void *pTxBuffer, void *pRxBuffer, uint16_t Len,
+                                   SPIBUS_Callback_t pfnDone, void *pContext) {
+    SPIBUS_Request_t **ppLink;
+    SPIBUS_Request_t *pStart = 0;
+    uint32_t basepri;
+
+    if ((Len == 0U) || (pBus->Spi.RxChannel == DMA_CHANNEL_NONE)) {
+        return SPIBUS_ERROR;
+    }
+    if (pReq->Busy) {
+        return SPIBUS_BUSY;
+    }
+
+    pReq->pDevice = pDevice;
+    pReq->Xfer.pTxBuffer = pTxBuffer;
+    pReq->Xfer.pRxBuffer = pRxBuffer;
+    pReq->Xfer.Len = Len;
+    pReq->Xfer.pCSPort = pDevice->pCSPort;
+    pReq->Xfer.CSPin = pDevice->CSPin;
+    pReq->Xfer.pfnDone = SPIBUS_Done;
+    pReq->Xfer.pContext = pBus;
+    pReq->pfnDone = pfnDone;
+    pReq->pContext = pContext;
+    pReq->Status = SPIBUS_OK;
+    pReq->Busy = 1;
+
+    basepri = NVIC_EnterCritical();
+    ppLink = &pBus->pQueue;
+    while ((*ppLink != 0) && ((*ppLink)->pDevice->Priority <= pDevice->Priority)) {
+        ppLink = &(*ppLink)->pNext;
+    }
+    pReq->pNext = *ppLink;
+    *ppLink = pReq;
+    if (pBus->pActive == 0) {
+        pStart = SPIBUS_Pop(pBus);
+    }
+    NVIC_ExitCritical(basepri);
+
+    // Only the caller that took the idle bus starts it; later ones run from SPIBUS_Done
+    if (pStart != 0) {
+        SPIBUS_Start(pBus, pStart);
+    }
+    return SPIBUS_OK;
+}
+
+/**
+ * @brief  1 while the request is queued or running
+ */
+uint8_t SPIBUS_IsBusy(const SPIBUS_Request_t *pReq) {
+    return pReq->Busy;
+}
@@ -0,0 +1,390 @@
+#include "swtimer.h"
+#include "nvic.h"
+
+/*
+ * Wheel state. g_next_tick is the next tick still to be processed, so
+ * "now" at the last hardware update event is g_next_tick - 1.
+ */
+static SWT_Timer_t *g_wheel[SWT_WHEEL_LEVELS][SWT_WHEEL_SLOTS];
+static uint32_t g_occupied[SWT_WHEEL_LEVELS][SWT_WHEEL_SLOTS / 32U];
+static uint32_t g_next_tick = 1;
+static uint32_t g_hw_ticks;          // Ticks until the pending update event
+static uint8_t g_dispatching;
+static TIM_Handle_t *g_swt_tim;
+
+// Helper to find the distance (0..63) from 'from' to the next occupied slot, circularly
+static uint32_t SWT_NextOccupied(const uint32_t *pOccupied, uint32_t from) {
+    uint32_t word = from >> 5;
+    uint32_t below = (1UL << (from & 31U)) - 1U;
+    uint32_t bits;
+
+    bits = pOccupied[word] & ~below;
+    if (bits) return ((word << 5) + (uint32_t)__builtin_ctz(bits) - from) & SWT_WHEEL_MASK;
+    bits = pOccupied[word ^ 1U];
+    if (bits) return (((word ^ 1U) << 5) + (uint32_t)__builtin_ctz(bits) - from) & SWT_WHEEL_MASK;
+    bits = pOccupied[word] & below;
+    return ((word << 5) + (uint32_t)__builtin_ctz(bits) - from) & SWT_WHEEL_MASK;
+}
+
+// Helper to link a timer into the slot matching its deadline
+static void SWT_Enqueue(SWT_Timer_t *pTimer) {
+    uint32_t delta = pTimer->Expires - g_next_tick;
+    uint32_t expires = pTimer->Expires;
+    uint32_t level = 0;
+    uint32_t slot;
+    SWT_Timer_t **ppHead;
+
+    if ((int32_t)delta < 0) {
+        // Overdue: run on the next tick
+        delta = 0;
+        expires = g_next_tick;
+    } else if (delta > SWT_MAX_TIMEOUT) {
+        // Beyond the wheel: park in the last level, re-cascaded later
+        delta = SWT_MAX_TIMEOUT;
+        expires = g_next_tick + SWT_MAX_TIMEOUT;
+    }
+
+    while (level < (SWT_WHEEL_LEVELS - 1U) && delta >= (1UL << (SWT_WHEEL_BITS * (level + 1U)))) {
+        level++;
+    }
+    slot = (expires >> (SWT_WHEEL_BITS * level)) & SWT_WHEEL_MASK;
+
+    ppHead = &g_wheel[level][slot];
+    pTimer->pNext = *ppHead;
+    if (*ppHead) {
+        (*ppHead)->ppPrev = &pTimer->pNext;
+    }
+    *ppHead = pTimer;
+    pTimer->ppPrev = ppHead;
+    pTimer->Level = (uint8_t)level;
+    pTimer->Slot = (uint8_t)slot;
+    g_occupied[level][slot >> 5] |= (1UL << (slot & 31U));
+}
+
+// Helper to unlink a timer from whatever list holds it
+static void SWT_Unlink(SWT_Timer_t *pTimer) {
+    *pTimer->ppPrev = pTimer->pNext;
+    if (pTimer->pNext) {
+        pTimer->pNext->ppPrev = pTimer->ppPrev;
+    }
+    if (g_wheel[pTimer->Level][pTimer->Slot] == 0) {
+        g_occupied[pTimer->Level][pTimer->Slot >> 5] &= ~(1UL << (pTimer->Slot & 31U));
+    }
+    pTimer->pNext = 0;
+    pTimer->ppPrev = 0;
+}
+
+// Helper to empty a slot and return its list
+static SWT_Timer_t *SWT_DetachSlot(uint32_t level, uint32_t slot) {
+    SWT_Timer_t *pList = g_wheel[level][slot];
+
+    g_wheel[level][slot] = 0;
+    g_occupied[level][slot >> 5] &= ~(1UL << (slot & 31U));
+    return pList;
+}
+
+// Helper to redistribute a coarse slot into the finer levels
+static void SWT_Cascade(uint32_t level, uint32_t slot) {
+    SWT_Timer_t *pTimer = SWT_DetachSlot(level, slot);
+
+    while (pTimer) {
+        SWT_Timer_t *pNext = pTimer->pNext;
+        SWT_Enqueue(pTimer);
+        pTimer = pNext;
+    }
+}
+
+// Helper to compute ticks from g_next_tick to the first expiry or cascade, capped at SWT_MAX_HW_TICKS
+static uint32_t SWT_NextEventDistance(void) {
+    uint32_t best = SWT_MAX_HW_TICKS;
+    uint32_t level;
+
+    for (level = 0; level < SWT_WHEEL_LEVELS; level++) {
+        uint32_t shift = SWT_WHEEL_BITS * level;
+        uint32_t to_boundary, index, dist;
+
+        if ((g_occupied[level][0] | g_occupied[level][1]) == 0) {
+            continue;
+        }
+
+        // Level k slots are only looked at on 64^k tick boundaries
+        to_boundary = (0U - g_next_tick) & ((1UL << shift) - 1U);
+        index = ((g_next_tick + to_boundary) >> shift) & SWT_WHEEL_MASK;
+        dist = to_boundary + (SWT_NextOccupied(g_occupied[level], index) << shift);
+        if (dist < best) {
+            best = dist;
+        }
+    }
+    return best;
+}
+
+// Helper to run tick g_next_tick: cascade, then fire the level 0 slot with interrupts restored
+static void SWT_ProcessTick(uint32_t *pBasepri) {
+    uint32_t tick = g_next_tick;
+    uint32_t level;
+    SWT_Timer_t *pPending;
+
+    for (level = 1; level < SWT_WHEEL_LEVELS; level++) {
+        if (tick & ((1UL << (SWT_WHEEL_BITS * level)) - 1U)) {
+            break;
+        }
+        SWT_Cascade(level, (tick >> (SWT_WHEEL_BITS * level)) & SWT_WHEEL_MASK);
+    }
+
+    // Move the due slot to a local list so callbacks may stop or start any timer
+    pPending = SWT_DetachSlot(0, tick & SWT_WHEEL_MASK);
+    if (pPending) {
+        pPending->ppPrev = &pPending;
+    }
+    g_next_tick = tick + 1U;
+
+    while (pPending) {
+        SWT_Timer_t *pTimer = pPending;
+
+        SWT_Unlink(pTimer);
+        if (pTimer->Period) {
+            pTimer->Expires += pTimer->Period;
+            SWT_Enqueue(pTimer);
+        }
+
+        NVIC_ExitCritical(*pBasepri);
+        pTimer->pfnCallback(pTimer, pTimer->pContext);
+        *pBasepri = NVIC_EnterCritical();
+    }
+}
+
+// Helper to load the next hardware period, measured from the last update event
+static void SWT_ProgramPeriod(uint32_t ticks) {
+    TIM_TypeDef *TIMx = g_swt_tim->pTIMx;
+    uint32_t cnt = TIMx->CNT;
+
+    // ARR is not preloaded: a value below CNT would let the counter run to 0xFFFF
+    if (ticks * SWT_COUNTS_PER_TICK <= cnt + 1U) {
+        ticks = (cnt / SWT_COUNTS_PER_TICK) + 2U;
+    }
+    if (ticks > SWT_MAX_HW_TICKS) {
+        ticks = SWT_MAX_HW_TICKS;
+    }
+    g_hw_ticks = ticks;
+    TIMx->ARR = (ticks * SWT_COUNTS_PER_TICK) - 1U;
+}
+
+// Helper returning ticks since the last processed update event
+static uint32_t SWT_ElapsedTicks(void) {
+    TIM_TypeDef *TIMx = g_swt_tim->pTIMx;
+    uint32_t cnt = TIMx->CNT;
+
+    // Counter already wrapped but the interrupt has not run yet
+    if (TIMx->SR & TIM_SR_UIF) {
+        return g_hw_ticks + (TIMx->CNT / SWT_COUNTS_PER_TICK);
+    }
+    return cnt / SWT_COUNTS_PER_TICK;
+}
+
+// Helper to run every tick up to and including target; caller holds the critical section
+static void SWT_AdvanceTo(uint32_t target, uint32_t *pBasepri) {
+    g_dispatching = 1;
+    while ((int32_t)(target - g_next_tick) >= 0) {
+        uint32_t dist = SWT_NextEventDistance();
+
+        // Ticks with no expiry and no cascade are skipped in one step
+        if (dist > (target - g_next_tick)) {
+            g_next_tick = target + 1U;
+            break;
+        }
+        g_next_tick += dist;
+        SWT_ProcessTick(pBasepri);
+    }
+    g_dispatching = 0;
+}
+
+// Helper to advance the wheel to the update event that just fired and re-arm the hardware
+static void SWT_Dispatch(void) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    SWT_AdvanceTo(g_next_tick - 1U + g_hw_ticks, &basepri);
+    SWT_ProgramPeriod(SWT_NextEventDistance() + 1U);
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Starts the timer service on a general-purpose timer. The wheel
+ *         owns the timer's PSC/ARR; the caller still routes the timer IRQ
+ *         to SWT_IRQHandler and enables it in the NVIC, at a priority no
+ *         higher than NVIC_CRITICAL_PRIORITY (the wheel's critical
+ *         sections use BASEPRI).
+ * @param  pTIMHandle: handle with pTIMx set (TIM2..TIM4 or TIM1)
+ */
+void SWT_Init(TIM_Handle_t *pTIMHandle) {
+    TIM_TypeDef *TIMx = pTIMHandle->pTIMx;
+
+    g_swt_tim = pTIMHandle;
+
+    pTIMHandle->BaseConfig.Prescaler = TIM_CalcPrescaler(TIMx, SWT_COUNTER_HZ);
+    pTIMHandle->BaseConfig.Period = (uint16_t)((SWT_MAX_HW_TICKS * SWT_COUNTS_PER_TICK) - 1U);
+    pTIMHandle->BaseConfig.CounterMode = TIM_COUNTERMODE_UP;
+    pTIMHandle->BaseConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    pTIMHandle->BaseConfig.SlaveMode = TIM_SLAVEMODE_DISABLE;
+    pTIMHandle->BaseConfig.InputTrigger = TIM_TS_ITR0;
+    TIM_Base_Init(pTIMHandle);
+
+    // ARR writes must act at once; URS keeps the UG below from raising an interrupt
+    TIMx->CR1 &= ~TIM_CR1_ARPE;
+    TIMx->CR1 |= TIM_CR1_URS;
+    TIMx->EGR = TIM_EGR_UG;
+    TIMx->SR = ~TIM_SR_UIF;
+
+    g_hw_ticks = SWT_MAX_HW_TICKS;
+    TIM_Base_Start_IT(TIMx);
+}
+
+/**
+ * @brief  Prepares a timer node. Must be called once before SWT_Start.
+ * @param  pTimer: caller-owned node
+ * @param  pfnCallback: called from the timer interrupt on expiry
+ * @param  pContext: passed back to the callback
+ */
+void SWT_TimerInit(SWT_Timer_t *pTimer, SWT_Callback_t pfnCallback, void *pContext) {
+    pTimer->pNext = 0;
+    pTimer->ppPrev = 0;
+    pTimer->Expires = 0;
+    pTimer->Period = 0;
+    pTimer->pfnCallback = pfnCallback;
+    pTimer->pContext = pContext;
+    pTimer->Level = 0;
+    pTimer->Slot = 0;
+}
+
+/**
+ * @brief  Arms (or re-arms) a timer. O(1).
+ * @param  pTimer: node prepared by SWT_TimerInit
+ * @param  Timeout: ticks (ms) until the first expiry, 0 means next tick
+ * @param  Period: reload in ticks for a periodic timer, 0 for one-shot
+ */
+void SWT_Start(SWT_Timer_t *pTimer, uint32_t Timeout, uint32_t Period) {
+    uint32_t basepri = NVIC_EnterCritical();
+    uint32_t elapsed;
+
+    if (pTimer->ppPrev) {
+        SWT_Unlink(pTimer);
+    }
+    if (Timeout == 0) {
+        Timeout = 1;
+    }
+
+    // Callbacks run "at" their tick, so restarts from them do not drift
+    elapsed = g_dispatching ? 0 : SWT_ElapsedTicks();
+    pTimer->Expires = g_next_tick - 1U + elapsed + Timeout;
+    pTimer->Period = Period;
+    SWT_Enqueue(pTimer);
+
+    // Pull the pending wakeup in if this deadline comes first
+    if (!g_dispatching && (elapsed + Timeout) < g_hw_ticks) {
+        SWT_ProgramPeriod(elapsed + Timeout);
+    }
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Cancels a timer. O(1); safe on an idle timer and from callbacks.
+ * @param  pTimer: node to cancel
+ */
+void SWT_Stop(SWT_Timer_t *pTimer) {
+    uint32_t basepri = NVIC_EnterCritical();
+
+    if (pTimer->ppPrev) {
+        SWT_Unlink(pTimer);
+    }
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Checks whether a timer is armed
+ * @param  pTimer: node to test
+ * @return 1 if armed, 0 otherwise
+ */
+uint8_t SWT_IsActive(const SWT_Timer_t *pTimer) {
+    return (pTimer->ppPrev != 0) ? 1U : 0U;
+}
+
+/**
+ * @brief  Current wheel time in ticks (ms since SWT_Init, wraps at 2^32)
+ */
+uint32_t SWT_GetTime(void) {
+    uint32_t basepri = NVIC_EnterCritical();
+    uint32_t now = g_next_tick - 1U + (g_dispatching ? 0 : SWT_ElapsedTicks());
+
+    NVIC_ExitCritical(basepri);
+    return now;
+}
+
+/**
+ * @brief  Ticks until the wheel next needs its timer interrupt (the earliest
+ *         expiry or cascade). LP_Idle uses it to bound the sleep, since STOP
+ *         mode also stops the wheel's timer.
+ * @return SWT_NO_DEADLINE when no timer is armed or SWT_Init was not called
+ */
+uint32_t SWT_NextDeadline(void) {
+    uint32_t remaining = SWT_NO_DEADLINE;
+    uint32_t basepri, level, due, elapsed;
+
+    if (g_swt_tim == 0) {
+        return SWT_NO_DEADLINE;
+    }
+
+    basepri = NVIC_EnterCritical();
+    for (level = 0; level < SWT_WHEEL_LEVELS; level++) {
+        if ((g_occupied[level][0] | g_occupied[level][1]) != 0) {
+            // Ticks from "now" (g_next_tick - 1 plus what the counter has run)
+            due = SWT_NextEventDistance() + 1U;
+            elapsed = SWT_ElapsedTicks();
+            remaining = (due > elapsed) ? (due - elapsed) : 0;
+            break;
+        }
+    }
+    NVIC_ExitCritical(basepri);
+    return remaining;
+}
+
+/**
+ * @brief  Moves the wheel on by time its timer did not count (STOP mode
+ *         gates the timer clock) and fires the timers that fell due,
+ *         late by at most the wakeup latency. Call with interrupts enabled:
+ *         the callbacks run from here.
+ * @param  ElapsedMs: time the timer was stopped, measured by another clock
+ *         (LP_Stop passes what the RTC counted)
+ */
+void SWT_CatchUp(uint32_t ElapsedMs) {
+    TIM_TypeDef *TIMx;
+    uint32_t basepri, target;
+
+    if ((g_swt_tim == 0) || (ElapsedMs == 0U)) {
+        return;
+    }
+    TIMx = g_swt_tim->pTIMx;
+
+    basepri = NVIC_EnterCritical();
+    // Wheel time when the counter froze, plus the time it stood still
+    target = g_next_tick - 1U + SWT_ElapsedTicks() + ElapsedMs;
+
+    // Restart the hardware period at the new "now" (sub-tick remainder dropped)
+    TIMx->CNT = 0;
+    TIMx->SR = ~TIM_SR_UIF;
+    SWT_AdvanceTo(target, &basepri);
+    SWT_ProgramPeriod(SWT_NextEventDistance() + 1U);
+    NVIC_ExitCritical(basepri);
+}
+
+/**
+ * @brief  Update interrupt of the wheel's timer. Call it from that timer's
+ *         vector in place of TIM_IRQHandler; TIM_PeriodElapsedCallback
+ *         stays free for the application's other timers.
+ */
+void SWT_IRQHandler(void) {
+    TIM_TypeDef *TIMx = g_swt_tim->pTIMx;
+
+    if (TIMx->SR & TIM_SR_UIF) {
+        TIMx->SR = ~TIM_SR_UIF;
+        SWT_Dispatch();
+    }
+}
@@ -1,70 +1,222 @@
 #include "systick.h"
+#include "rcc.h"
+#include "dwt.h"
 
 
 static uint32_t g_system_clock = 8000000; // Default 8MHz
+static RCC_ClockNotifier_t g_systick_notifier;
+static volatile uint32_t g_ticks = 0;     // Milliseconds since SysTick_Init
 
-/**
- * @brief  Initialize SysTick driver
- * @param  system_clock_freq: System clock frequency in Hz
- */
-void SysTick_Init(uint32_t system_clock_freq) {
-    g_system_clock = system_clock_freq;
-    
-    // Disable SysTick during setup
+// Helper to program a 1 kHz tick from g_system_clock
+static void SysTick_StartTick(void) {
     SysTick->CTRL = 0;
-    
-    // We will use SysTick for simple polling delays mostly, 
-    // but if we wanted interrupts we would configure it here.
-    // For now, let's just ensure it's reset.
+    SysTick->LOAD = (g_system_clock / SYSTICK_TICK_HZ) - 1U;
     SysTick->VAL = 0;
+    // Core clock source, interrupt on every reload
+    SysTick->CTRL = SYSTICK_CTRL_CLKSOURCE_Msk | SYSTICK_CTRL_TICKINT_Msk | SYSTICK_CTRL_ENABLE_Msk;
+}
+
+/* Clock change listener: the tick stays at 1 kHz with the new HCLK */
+static void SysTick_ClockNotify(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext) {
+    (void)pContext;
+    if (Event == RCC_CLOCK_EVENT_POST_CHANGE) {
+        g_system_clock = pClocks->HCLK_Frequency;
+        SysTick_StartTick();
+    }
+}
+
+/**
+ * @brief  Initialize SysTick as a 1 kHz interrupt tick from the current HCLK
+ *         (later RCC_ClockSwitch calls are followed automatically)
+ */
+void SysTick_Init(void) {
+    RCC_Clocks_t clocks;
+    RCC_GetClocksFreq(&clocks);
+    g_system_clock = clocks.HCLK_Frequency;
+
+    g_systick_notifier.pfnNotify = SysTick_ClockNotify;
+    RCC_RegisterClockNotifier(&g_systick_notifier);
+
+    SysTick_StartTick();
+
+    // delay_us runs on the DWT cycle counter
+    DWT_Init();
+}
+
+/**
+ * @brief  SysTick exception, overrides the weak alias in the startup file
+ */
+void v_v_sys_tick_handler(void) {
+    g_ticks++;
+    SysTick_Callback();
+}
+
+__attribute__((weak)) void SysTick_Callback(void) {
+    // Weak implementation
+}
+
+/**
+ * @brief  Milliseconds elapsed since SysTick_Init (wraps after ~49 days)
+ */
+uint32_t millis(void) {
+    return g_ticks;
+}
+
+/**
+ * @brief  Arms a timeout
+ * @param  pTimeout: timeout to arm
+ * @param  ms: duration in milliseconds; expiry happens between ms-1 and ms
+ *         after the call since the current tick is already partly elapsed
+ */
+void timeout_start(timeout_t *pTimeout, uint32_t ms) {
+    pTimeout->start = g_ticks;
+    pTimeout->duration = ms;
+}
+
+/**
+ * @brief  Re-arms an expired timeout one period after its previous start,
+ *         so periodic work does not drift by the polling latency
+ * @param  pTimeout: timeout previously armed with timeout_start
+ */
+void timeout_restart(timeout_t *pTimeout) {
+    pTimeout->start += pTimeout->duration;
+}
+
+/**
+ * @brief  Checks a timeout without blocking
+ * @param  pTimeout: timeout armed with timeout_start
+ * @return 1 once the duration has elapsed, 0 before
+ */
+uint8_t timeout_expired(const timeout_t *pTimeout) {
+    // Unsigned subtraction stays correct across the g_ticks wrap
+    return (uint32_t)(g_ticks - pTimeout->start) >= pTimeout->duration;
+}
+
+/**
+ * @brief  Milliseconds left before a timeout expires
+ * @param  pTimeout: timeout armed with timeout_start
+ * @return Remaining time, 0 if already expired
+ */
+uint32_t timeout_remaining(const timeout_t *pTimeout) {
+    uint32_t elapsed = g_ticks - pTimeout->start;
+    return (elapsed >= pTimeout->duration) ? 0 : (pTimeout->duration - elapsed);
 }
 
 /**
  * @brief  Delay for a specified number of milliseconds
+ *         The core sleeps (WFI) between ticks; any interrupt also wakes it and
+ *         is serviced normally. SysTick_Init must have been called.
  * @param  ms: Number of milliseconds to delay
  */
 void delay_ms(uint32_t ms) {
-    // Calculate the number of ticks for 1ms
-    // SysTick clock source is AHB (HCLK) or AHB/8. 
-    // We'll use AHB clock (CLKSOURCE = 1).
-    
-    uint32_t ticks_per_ms = g_system_clock / 1000;
-    
-    // Load the value
-    SysTick->LOAD = ticks_per_ms - 1;
-    SysTick->VAL = 0;
-    
-    // Enable SysTick with core clock source
-    SysTick->CTRL = SYSTICK_CTRL_ENABLE_Msk | SYSTICK_CTRL_CLKSOURCE_Msk;
-    
-    for (uint32_t i = 0; i < ms; i++) {
-        // Wait until the COUNTFLAG is set
-        while (!((SysTick->CTRL) & SYSTICK_CTRL_COUNTFLAG_Msk));
+    timeout_t timeout;
+    // +1 so the delay is at least ms even when called just before a tick
+    timeout_start(&timeout, ms + 1U);
+
+    while (!timeout_expired(&timeout)) {
+        __asm volatile ("wfi");
     }
-    
-    // Disable SysTick
-    SysTick->CTRL = 0;
 }
 
 /**
  * @brief  Delay for a specified number of microseconds
+ *         Busy-waits on the DWT cycle counter (see delay_cycles).
  * @param  us: Number of microseconds to delay
  */
 void delay_us(uint32_t us) {
-    uint32_t ticks_per_us = g_system_clock / 1000000;
-    
-    // Load the value
-    SysTick->LOAD = ticks_per_us - 1;
+    delay_cycles(us_to_cycles(us));
+}
+
+/**
+ * @brief  Sleeps (WFI) for up to ms ticks with the periodic tick suppressed:
+ *         SysTick is reloaded once for the whole interval, then millis() is
+ *         compensated and the tick phase restored on wakeup. Any interrupt
+ *         ends the sleep early; it is serviced after the compensation.
+ * @param  ms: ticks to sleep, clamped to what the 24-bit counter can hold
+ *         (~233 ms at 72MHz)
+ * @return Core clock cycles actually spent asleep
+ */
+uint32_t SysTick_TicklessSleep(uint32_t ms) {
+    uint32_t per_tick = g_system_clock / SYSTICK_TICK_HZ;
+    uint32_t max_ticks = SYSTICK_LOAD_MAX / per_tick;
+    uint32_t primask, cur, reload, ctrl, slept, ticks, next;
+
+    if (ms == 0) {
+        return 0;
+    }
+    if (ms > max_ticks) {
+        ms = max_ticks;
+    }
+
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) :: "memory");
+
+    // Freeze the counter; cycles left in the current tick
+    SysTick->CTRL &= ~SYSTICK_CTRL_ENABLE_Msk;
+    cur = SysTick->VAL;
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET) {
+        // A tick is already due: let it run instead of sleeping
+        SysTick->CTRL |= SYSTICK_CTRL_ENABLE_Msk;
+        __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+        return 0;
+    }
+    if (cur == 0) {
+        cur = per_tick;
+    }
+
+    // One reload covering the rest of this tick plus ms-1 whole ticks
+    reload = cur + ((ms - 1U) * per_tick);
+    SysTick->LOAD = reload - 1U;
     SysTick->VAL = 0;
-    
-    // Enable SysTick with core clock source
-    SysTick->CTRL = SYSTICK_CTRL_ENABLE_Msk | SYSTICK_CTRL_CLKSOURCE_Msk;
-    
-    for (uint32_t i = 0; i < us; i++) {
-        // Wait until the COUNTFLAG is set
-        while (!((SysTick->CTRL) & SYSTICK_CTRL_COUNTFLAG_Msk));
+    SysTick->CTRL |= SYSTICK_CTRL_ENABLE_Msk;
+
+    __asm volatile ("dsb\n\twfi\n\tisb" ::: "memory");
+
+    // Reading CTRL clears COUNTFLAG: one read, then a plain write to stop the counter
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SYSTICK_CTRL_ENABLE_Msk;
+    if ((ctrl & SYSTICK_CTRL_COUNTFLAG_Msk) || (SCB->ICSR & SCB_ICSR_PENDSTSET)) {
+        // Slept the full interval; this exception is accounted for here
+        SCB->ICSR = SCB_ICSR_PENDSTCLR;
+        slept = reload;
+        ticks = ms;
+        next = per_tick;
+    } else {
+        // Woken early: count whole ticks, finish the partial one on schedule
+        slept = reload - SysTick->VAL;
+        if (slept < cur) {
+            ticks = 0;
+            next = cur - slept;
+        } else {
+            ticks = 1U + ((slept - cur) / per_tick);
+            next = per_tick - ((slept - cur) % per_tick);
+        }
     }
-    
-    // Disable SysTick
-    SysTick->CTRL = 0;
+    g_ticks += ticks;
+
+    // Resume the 1 kHz tick in phase: a short first period, then normal reloads
+    SysTick->LOAD = next - 1U;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SYSTICK_CTRL_ENABLE_Msk;
+    SysTick->LOAD = per_tick - 1U;
+
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+    return slept;
+}
+
+/**
+ * @brief  Stops the tick, e.g. before STOP mode where HCLK is gated
+ */
+void SysTick_Suspend(void) {
+    SysTick->CTRL &= ~(SYSTICK_CTRL_ENABLE_Msk | SYSTICK_CTRL_TICKINT_Msk);
+    SCB->ICSR = SCB_ICSR_PENDSTCLR;
+}
+
+/**
+ * @brief  Restarts the tick after SysTick_Suspend
+ * @param  ElapsedMs: time spent suspended (measured by another clock such
+ *         as the RTC), added to millis()
+ */
+void SysTick_Resume(uint32_t ElapsedMs) {
+    g_ticks += ElapsedMs;
+    SysTick_StartTick();
 }
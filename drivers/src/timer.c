@@ -1,6 +1,7 @@
 #include "timer.h"
 #include "rcc.h"
 #include "gpio.h"
+#include "nvic.h"
 
 // Helper function to enable clock for a given timer
 static void TIM_EnableClock(TIM_TypeDef *TIMx) {
@@ -10,6 +11,47 @@ static void TIM_EnableClock(TIM_TypeDef *TIMx) {
     else if (TIMx == TIM4) RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
 }
 
+// Clock change listener: keep the counter rate, PSC takes effect at the next update event
+static void TIM_ClockNotify(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext) {
+    TIM_Handle_t *pTIMHandle = (TIM_Handle_t *)pContext;
+    (void)pClocks;
+
+    if (Event == RCC_CLOCK_EVENT_POST_CHANGE && pTIMHandle->CounterFreq != 0) {
+        pTIMHandle->pTIMx->PSC = TIM_CalcPrescaler(pTIMHandle->pTIMx, pTIMHandle->CounterFreq);
+    }
+}
+
+/**
+ * @brief  Returns the kernel clock feeding the TIMx prescaler.
+ * @param  TIMx: TIM1 (APB2) or TIM2..TIM4 (APB1).
+ * @return Timer clock in Hz (twice PCLKx when the APB prescaler is not 1).
+ */
+uint32_t TIM_GetClockFreq(TIM_TypeDef *TIMx) {
+    RCC_Clocks_t clocks;
+    RCC_GetClocksFreq(&clocks);
+    return (TIMx == TIM1) ? clocks.TIMCLK2_Frequency : clocks.TIMCLK1_Frequency;
+}
+
+/**
+ * @brief  Computes the PSC value giving the requested counter frequency
+ *         from the current clock tree.
+ * @param  TIMx: timer the prescaler is meant for.
+ * @param  CounterFreq: desired CNT increment rate in Hz.
+ * @return Value for TIM_Base_Config_t.Prescaler (clamped to 0..0xFFFF).
+ */
+uint16_t TIM_CalcPrescaler(TIM_TypeDef *TIMx, uint32_t CounterFreq) {
+    uint32_t div;
+
+    if (CounterFreq == 0) {
+        return 0xFFFF;
+    }
+
+    div = (TIM_GetClockFreq(TIMx) + (CounterFreq / 2U)) / CounterFreq; // Rounded
+    if (div == 0) div = 1;
+    if (div > 0x10000U) div = 0x10000U;
+    return (uint16_t)(div - 1U);
+}
+
 void TIM_Base_Init(TIM_Handle_t *pTIMHandle) {
     TIM_EnableClock(pTIMHandle->pTIMx);
 
@@ -25,6 +67,26 @@ void TIM_Base_Init(TIM_Handle_t *pTIMHandle) {
     } else {
         pTIMHandle->pTIMx->CR1 |= TIM_CR1_DIR;
     }
+
+    // 4. Master mode: what this timer drives on TRGO
+    pTIMHandle->pTIMx->CR2 &= ~TIM_CR2_MMS_Msk;
+    pTIMHandle->pTIMx->CR2 |= (pTIMHandle->BaseConfig.MasterOutputTrigger & TIM_CR2_MMS_Msk);
+
+    // 5. Slave mode: TS may only change while SMS is disabled
+    pTIMHandle->pTIMx->SMCR &= ~(TIM_SMCR_SMS_Msk | TIM_SMCR_TS_Msk);
+    pTIMHandle->pTIMx->SMCR |= (pTIMHandle->BaseConfig.InputTrigger & TIM_SMCR_TS_Msk);
+    pTIMHandle->pTIMx->SMCR |= (pTIMHandle->BaseConfig.SlaveMode & TIM_SMCR_SMS_Msk);
+
+    // 6. Remember the counter rate so PSC can follow clock changes
+    //    (not applicable when the counter is clocked by its trigger input)
+    if (pTIMHandle->BaseConfig.SlaveMode == TIM_SLAVEMODE_EXTERNAL1) {
+        pTIMHandle->CounterFreq = 0;
+    } else {
+        pTIMHandle->CounterFreq = TIM_GetClockFreq(pTIMHandle->pTIMx) / ((uint32_t)pTIMHandle->BaseConfig.Prescaler + 1U);
+    }
+    pTIMHandle->ClockNotifier.pfnNotify = TIM_ClockNotify;
+    pTIMHandle->ClockNotifier.pContext = pTIMHandle;
+    RCC_RegisterClockNotifier(&pTIMHandle->ClockNotifier);
 }
 
 void TIM_Base_Start(TIM_TypeDef *TIMx) {
@@ -189,31 +251,26 @@ uint32_t TIM_IC_ReadCaptureValue(TIM_TypeDef *TIMx, uint8_t Channel) {
     return 0;
 }
 
+/**
+ * @brief  Enables or disables the interrupt in the NVIC (see nvic.h)
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  EnorDi: ENABLE or DISABLE
+ */
 void TIM_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi) {
-    if (EnorDi == 1) { // Enable
-        if (IRQNumber <= 31) {
-            NVIC->ISER[0] |= (1 << IRQNumber);
-        } else if (IRQNumber > 31 && IRQNumber < 64) {
-            NVIC->ISER[1] |= (1 << (IRQNumber % 32));
-        } else if (IRQNumber >= 64 && IRQNumber < 96) {
-            NVIC->ISER[2] |= (1 << (IRQNumber % 64));
-        }
-    } else { // Disable
-        if (IRQNumber <= 31) {
-            NVIC->ICER[0] |= (1 << IRQNumber);
-        } else if (IRQNumber > 31 && IRQNumber < 64) {
-            NVIC->ICER[1] |= (1 << (IRQNumber % 32));
-        } else if (IRQNumber >= 64 && IRQNumber < 96) {
-            NVIC->ICER[2] |= (1 << (IRQNumber % 64));
-        }
+    if (EnorDi == ENABLE) {
+        NVIC_EnableIRQ(IRQNumber);
+    } else {
+        NVIC_DisableIRQ(IRQNumber);
     }
 }
 
+/**
+ * @brief  Sets the NVIC priority of the interrupt (see nvic.h)
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  IRQPriority: 0..15, lower is more urgent
+ */
 void TIM_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority) {
-    uint8_t iprx = IRQNumber / 4;
-    uint8_t iprx_section = IRQNumber % 4;
-    uint8_t shift_amount = (8 * iprx_section) + (8 - 4); // 4 bits implemented
-    NVIC->IP[iprx] |= (IRQPriority << shift_amount);
+    NVIC_SetPriority(IRQNumber, (uint8_t)IRQPriority);
 }
 
 void TIM_IRQHandler(TIM_Handle_t *pTIMHandle) {
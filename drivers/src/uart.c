@@ -1,6 +1,10 @@
 #include "uart.h"
 #include "rcc.h"
 #include "gpio.h"
+#include "nvic.h"
+
+_Static_assert((UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1U)) == 0U, "UART_TX_BUFFER_SIZE must be a power of two");
+_Static_assert((UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1U)) == 0U, "UART_RX_BUFFER_SIZE must be a power of two");
 
 // Helper to enable clock
 static void UART_EnableClock(USART_TypeDef *USARTx) {
@@ -11,8 +15,119 @@ static void UART_EnableClock(USART_TypeDef *USARTx) {
 
 // Helper to get PCLK frequency
 static uint32_t UART_GetPCLKFrequency(USART_TypeDef *USARTx) {
-    if (USARTx == USART1) return 72000000; // APB2 (Assuming 72MHz)
-    else return 36000000; // APB1 (Assuming 36MHz)
+    RCC_Clocks_t clocks;
+    RCC_GetClocksFreq(&clocks);
+    if (USARTx == USART1) return clocks.PCLK2_Frequency; // APB2
+    else return clocks.PCLK1_Frequency; // APB1
+}
+
+// Helper to program BRR from the current PCLK
+static void UART_SetBaudRate(UART_Handle_t *pUARTHandle) {
+    uint32_t pclk = UART_GetPCLKFrequency(pUARTHandle->pUSARTx);
+    uint32_t usartdiv = (pclk * 25U) / (4U * pUARTHandle->UART_Config.BaudRate); // pclk*100/(16*baud) without overflowing at 72MHz
+    uint32_t mantissa = usartdiv / 100;
+    uint32_t fraction = (usartdiv - (mantissa * 100));
+    fraction = (fraction * 16 + 50) / 100; // Rounding
+
+    if (fraction > 0xF) { // Rounded up into the next mantissa step
+        mantissa++;
+        fraction = 0;
+    }
+
+    pUARTHandle->pUSARTx->BRR = (mantissa << 4) | (fraction & 0xF);
+}
+
+// Clock change listener: hold the TX feed while the bit clock is wrong
+static void UART_ClockNotify(uint8_t Event, const RCC_Clocks_t *pClocks, void *pContext) {
+    UART_Handle_t *pUARTHandle = (UART_Handle_t *)pContext;
+    USART_TypeDef *pUSARTx = pUARTHandle->pUSARTx;
+    volatile uint32_t timeout = 0;
+    (void)pClocks;
+
+    if (Event == RCC_CLOCK_EVENT_PRE_CHANGE) {
+        // 1. Stop refilling DR from the ring or the DMA
+        pUARTHandle->ClockSuspendedTx = pUSARTx->CR3 & USART_CR3_DMAT;
+        if (pUSARTx->CR1 & USART_CR1_TXEIE) {
+            pUARTHandle->ClockSuspendedTx |= USART_CR1_TXEIE;
+            BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TXEIE_Pos) = 0;
+        }
+        pUSARTx->CR3 &= ~USART_CR3_DMAT;
+
+        // 2. Let the byte in flight finish at the old baud rate
+        if (pUSARTx->CR1 & USART_CR1_TE) {
+            while (!(pUSARTx->SR & USART_SR_TC)) {
+                if (++timeout > 100000) break;
+            }
+        }
+    } else {
+        UART_SetBaudRate(pUARTHandle);
+
+        if (pUARTHandle->ClockSuspendedTx & USART_CR3_DMAT) {
+            pUSARTx->CR3 |= USART_CR3_DMAT;
+        }
+        if (pUARTHandle->ClockSuspendedTx & USART_CR1_TXEIE) {
+            BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TXEIE_Pos) = 1;
+        }
+        pUARTHandle->ClockSuspendedTx = 0;
+    }
+}
+
+// Helper to get the DMA request of USARTx_TX
+static uint8_t UART_GetTxDMARequest(USART_TypeDef *USARTx) {
+    if (USARTx == USART1) return DMA_REQ_USART1_TX;
+    else if (USARTx == USART2) return DMA_REQ_USART2_TX;
+    else return DMA_REQ_USART3_TX;
+}
+
+// Helper to get the DMA request of USARTx_RX
+static uint8_t UART_GetRxDMARequest(USART_TypeDef *USARTx) {
+    if (USARTx == USART1) return DMA_REQ_USART1_RX;
+    else if (USARTx == USART2) return DMA_REQ_USART2_RX;
+    else return DMA_REQ_USART3_RX;
+}
+
+// Helper to hand everything the DMA wrote since the last call to the application
+static void UART_RxDMA_Process(UART_Handle_t *pUARTHandle) {
+    uint16_t size = pUARTHandle->RxDMASize;
+    uint16_t pos = (uint16_t)(size - DMA_GetRemaining(pUARTHandle->RxDMAChannel));
+    uint16_t old = pUARTHandle->RxDMAReadPos;
+
+    if (pos == old) {
+        return;
+    }
+
+    if (pos > old) {
+        // Contiguous slice (pos == size means the write pointer just wrapped)
+        UART_RxEventCallback(pUARTHandle, &pUARTHandle->pRxDMABuffer[old], (uint16_t)(pos - old), 0, 0);
+    } else {
+        // Wrapped: tail of the buffer followed by its head
+        UART_RxEventCallback(pUARTHandle, &pUARTHandle->pRxDMABuffer[old], (uint16_t)(size - old),
+                             pUARTHandle->pRxDMABuffer, pos);
+    }
+
+    pUARTHandle->RxDMAReadPos = (pos == size) ? 0 : pos;
+}
+
+// Helper to hand the next non-empty segment to the DMA channel
+// Returns 0 when the chain is exhausted
+static uint8_t UART_DMA_StartNextSegment(UART_Handle_t *pUARTHandle, DMA_Channel_TypeDef *pChannel) {
+    uint8_t index = pUARTHandle->TxSegmentIndex;
+
+    while (index < pUARTHandle->TxSegmentCount && pUARTHandle->pTxSegments[index].Len == 0) {
+        index++;
+    }
+    pUARTHandle->TxSegmentIndex = index;
+
+    if (index >= pUARTHandle->TxSegmentCount) {
+        return 0;
+    }
+
+    // CMAR/CNDTR are only writable while the channel is disabled
+    pChannel->CCR &= ~DMA_CCR_EN;
+    pChannel->CMAR = (uint32_t)pUARTHandle->pTxSegments[index].pData;
+    pChannel->CNDTR = pUARTHandle->pTxSegments[index].Len;
+    pChannel->CCR |= DMA_CCR_EN;
+    return 1;
 }
 
 void UART_Init(UART_Handle_t *pUARTHandle) {
@@ -36,18 +151,21 @@ void UART_Init(UART_Handle_t *pUARTHandle) {
     pUARTHandle->pUSARTx->CR3 &= ~(0x300); // Clear CTSE/RTSE
     pUARTHandle->pUSARTx->CR3 |= pUARTHandle->UART_Config.HwFlowCtl;
 
-    // 6. Configure Baud Rate
-    uint32_t pclk = UART_GetPCLKFrequency(pUARTHandle->pUSARTx);
-    uint32_t usartdiv = (pclk * 100) / (16 * pUARTHandle->UART_Config.BaudRate); // *100 to keep 2 decimal places
-    uint32_t mantissa = usartdiv / 100;
-    uint32_t fraction = (usartdiv - (mantissa * 100));
-    fraction = (fraction * 16 + 50) / 100; // Rounding
-
-    pUARTHandle->pUSARTx->BRR = (mantissa << 4) | (fraction & 0xF);
+    // 6. Configure Baud Rate, and again whenever the clock tree changes
+    UART_SetBaudRate(pUARTHandle);
+    pUARTHandle->ClockSuspendedTx = 0;
+    pUARTHandle->ClockNotifier.pfnNotify = UART_ClockNotify;
+    pUARTHandle->ClockNotifier.pContext = pUARTHandle;
+    RCC_RegisterClockNotifier(&pUARTHandle->ClockNotifier);
 
     // 7. Enable UART
     tempreg |= USART_CR1_UE;
     pUARTHandle->pUSARTx->CR1 = tempreg;
+
+    pUARTHandle->TxDMABusy = 0;
+    pUARTHandle->TxDMAChannel = DMA_CHANNEL_NONE;
+    pUARTHandle->RxDMAChannel = DMA_CHANNEL_NONE;
+    pUARTHandle->pRxDMABuffer = 0;
 }
 
 void UART_Transmit(UART_Handle_t *pUARTHandle, uint8_t *pTxBuffer, uint32_t Len) {
@@ -77,27 +195,387 @@ uint8_t UART_ReceiveByte(UART_Handle_t *pUARTHandle) {
     return (uint8_t)(pUARTHandle->pUSARTx->DR & 0xFF);
 }
 
+/**
+ * @brief  Enables or disables the interrupt in the NVIC (see nvic.h)
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  EnorDi: ENABLE or DISABLE
+ */
 void UART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t EnorDi) {
-    if (EnorDi == 1) {
-        if (IRQNumber <= 31) NVIC->ISER[0] |= (1 << IRQNumber);
-        else if (IRQNumber < 64) NVIC->ISER[1] |= (1 << (IRQNumber % 32));
-        else if (IRQNumber < 96) NVIC->ISER[2] |= (1 << (IRQNumber % 64));
+    if (EnorDi == ENABLE) {
+        NVIC_EnableIRQ(IRQNumber);
     } else {
-        if (IRQNumber <= 31) NVIC->ICER[0] |= (1 << IRQNumber);
-        else if (IRQNumber < 64) NVIC->ICER[1] |= (1 << (IRQNumber % 32));
-        else if (IRQNumber < 96) NVIC->ICER[2] |= (1 << (IRQNumber % 64));
+        NVIC_DisableIRQ(IRQNumber);
     }
 }
 
+/**
+ * @brief  Sets the NVIC priority of the interrupt (see nvic.h)
+ * @param  IRQNumber: IRQ_NO_x
+ * @param  IRQPriority: 0..15, lower is more urgent
+ */
 void UART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority) {
-    uint8_t iprx = IRQNumber / 4;
-    uint8_t iprx_section = IRQNumber % 4;
-    uint8_t shift_amount = (8 * iprx_section) + (8 - 4);
-    NVIC->IP[iprx] |= (IRQPriority << shift_amount);
+    NVIC_SetPriority(IRQNumber, (uint8_t)IRQPriority);
+}
+
+/**
+ * @brief  Resets the ring buffers and enables the RXNE interrupt.
+ *         The USART IRQ must also be enabled in the NVIC and its vector must
+ *         call UART_IRQHandler with this handle.
+ * @param  pUARTHandle: pointer to an initialized UART handle.
+ */
+void UART_EnableIT(UART_Handle_t *pUARTHandle) {
+    pUARTHandle->TxRing.Head = 0;
+    pUARTHandle->TxRing.Tail = 0;
+    pUARTHandle->RxRing.Head = 0;
+    pUARTHandle->RxRing.Tail = 0;
+    pUARTHandle->RxDropped = 0;
+
+    // Discard anything received before the rings were ready
+    (void)pUARTHandle->pUSARTx->SR;
+    (void)pUARTHandle->pUSARTx->DR;
+
+    pUARTHandle->pUSARTx->CR1 |= USART_CR1_RXNEIE;
+}
+
+/**
+ * @brief  Disables all UART interrupt sources used by the ring buffers.
+ *         Bytes still queued in TxBuffer are not sent.
+ * @param  pUARTHandle: pointer to an initialized UART handle.
+ */
+void UART_DisableIT(UART_Handle_t *pUARTHandle) {
+    pUARTHandle->pUSARTx->CR1 &= ~(USART_CR1_RXNEIE | USART_CR1_TXEIE | USART_CR1_TCIE);
+}
+
+/**
+ * @brief  Queues up to Len bytes for interrupt-driven transmission.
+ *         Never blocks; the caller retries with the remainder.
+ * @param  pUARTHandle: pointer to a UART handle in interrupt mode.
+ * @param  pTxBuffer: data to send.
+ * @param  Len: number of bytes offered.
+ * @return Number of bytes actually queued.
+ */
+uint32_t UART_Write(UART_Handle_t *pUARTHandle, const uint8_t *pTxBuffer, uint32_t Len) {
+    uint16_t head = pUARTHandle->TxRing.Head;
+    uint32_t space = UART_TX_BUFFER_SIZE - (uint16_t)(head - pUARTHandle->TxRing.Tail);
+    uint32_t count = (Len < space) ? Len : space;
+
+    for (uint32_t i = 0; i < count; i++) {
+        pUARTHandle->TxBuffer[(uint16_t)(head + i) & (UART_TX_BUFFER_SIZE - 1U)] = pTxBuffer[i];
+    }
+
+    if (count != 0) {
+        // Publish the data before the index, then (re)arm TXE
+        COMPILER_BARRIER();
+        pUARTHandle->TxRing.Head = (uint16_t)(head + count);
+        // Bit-band writes so a concurrent TXE/TC interrupt cannot lose its own CR1 update
+        BITBAND_PERIPH(pUARTHandle->pUSARTx->CR1, USART_CR1_TCIE_Pos) = 0;
+        BITBAND_PERIPH(pUARTHandle->pUSARTx->CR1, USART_CR1_TXEIE_Pos) = 1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief  Takes up to Len received bytes from the RX ring buffer.
+ *         Never blocks.
+ * @param  pUARTHandle: pointer to a UART handle in interrupt mode.
+ * @param  pRxBuffer: destination buffer.
+ * @param  Len: capacity of pRxBuffer.
+ * @return Number of bytes copied.
+ */
+uint32_t UART_Read(UART_Handle_t *pUARTHandle, uint8_t *pRxBuffer, uint32_t Len) {
+    uint16_t tail = pUARTHandle->RxRing.Tail;
+    uint32_t avail = (uint16_t)(pUARTHandle->RxRing.Head - tail);
+    uint32_t count = (Len < avail) ? Len : avail;
+
+    COMPILER_BARRIER();
+    for (uint32_t i = 0; i < count; i++) {
+        pRxBuffer[i] = pUARTHandle->RxBuffer[(uint16_t)(tail + i) & (UART_RX_BUFFER_SIZE - 1U)];
+    }
+    COMPILER_BARRIER();
+
+    pUARTHandle->RxRing.Tail = (uint16_t)(tail + count);
+    return count;
+}
+
+/**
+ * @brief  Returns how many bytes UART_Write can currently accept.
+ */
+uint32_t UART_TxFree(UART_Handle_t *pUARTHandle) {
+    return UART_TX_BUFFER_SIZE - (uint16_t)(pUARTHandle->TxRing.Head - pUARTHandle->TxRing.Tail);
+}
+
+/**
+ * @brief  Returns how many received bytes are waiting for UART_Read.
+ */
+uint32_t UART_RxAvailable(UART_Handle_t *pUARTHandle) {
+    return (uint16_t)(pUARTHandle->RxRing.Head - pUARTHandle->RxRing.Tail);
+}
+
+// DMA TX transfer error: the hardware has disabled the channel
+static RAMFUNC void UART_DMA_TxError(uint8_t Channel, void *pContext) {
+    UART_Handle_t *pUARTHandle = (UART_Handle_t *)pContext;
+
+    pUARTHandle->pUSARTx->CR3 &= ~USART_CR3_DMAT;
+    DMA_Release(Channel);
+    pUARTHandle->TxDMAChannel = DMA_CHANNEL_NONE;
+    pUARTHandle->TxDMABusy = 0;
+    UART_ApplicationEventCallback(pUARTHandle, UART_EVENT_DMA_TX_ERROR);
+}
+
+// DMA TX transfer complete: chain the next segment, or arm the USART TC interrupt after the last one
+static RAMFUNC void UART_DMA_TxComplete(uint8_t Channel, void *pContext) {
+    UART_Handle_t *pUARTHandle = (UART_Handle_t *)pContext;
+
+    pUARTHandle->TxSegmentIndex++;
+    if (!UART_DMA_StartNextSegment(pUARTHandle, DMA_GetChannel(Channel))) {
+        // All data handed to the USART; the channel is free again
+        pUARTHandle->pUSARTx->CR3 &= ~USART_CR3_DMAT;
+        DMA_Release(Channel);
+        pUARTHandle->TxDMAChannel = DMA_CHANNEL_NONE;
+        BITBAND_PERIPH(pUARTHandle->pUSARTx->CR1, USART_CR1_TCIE_Pos) = 1;
+    }
+}
+
+// DMA RX half or full buffer: report what arrived
+static RAMFUNC void UART_DMA_RxEvent(uint8_t Channel, void *pContext) {
+    (void)Channel;
+    UART_RxDMA_Process((UART_Handle_t *)pContext);
+}
+
+// DMA RX transfer error: reception stops
+static RAMFUNC void UART_DMA_RxError(uint8_t Channel, void *pContext) {
+    UART_Handle_t *pUARTHandle = (UART_Handle_t *)pContext;
+    (void)Channel;
+
+    UART_StopReceiveDMA(pUARTHandle);
+    UART_ApplicationEventCallback(pUARTHandle, UART_EVENT_DMA_RX_ERROR);
+}
+
+/**
+ * @brief  Sends a chain of segments back-to-back through the USART TX DMA
+ *         channel. The CPU only intervenes once per segment; completion is
+ *         reported with UART_EVENT_TX_CMPLT once the last byte is on the wire.
+ *         The channel is claimed from the DMA manager for the duration of
+ *         the transmission; the USART vector must call UART_IRQHandler.
+ * @param  pUARTHandle: pointer to an initialized UART handle.
+ * @param  pSegments: segment array, must stay valid until completion.
+ * @param  NumSegments: number of entries in pSegments.
+ * @return UART_OK if started, UART_BUSY if a DMA transmission is in flight
+ *         or another driver holds the channel, UART_ERROR if every segment
+ *         is empty (there would be no UART_EVENT_TX_CMPLT).
+ */
+UART_Status UART_TransmitDMA(UART_Handle_t *pUARTHandle, const UART_TxSegment_t *pSegments, uint8_t NumSegments) {
+    USART_TypeDef *pUSARTx = pUARTHandle->pUSARTx;
+    DMA_Channel_TypeDef *pChannel;
+    DMA_Init_t dmaInit;
+    uint8_t channel;
+    uint32_t total = 0;
+
+    if (pUARTHandle->TxDMABusy) {
+        return UART_BUSY;
+    }
+
+    for (uint8_t i = 0; i < NumSegments; i++) {
+        total += pSegments[i].Len;
+    }
+    if (total == 0U) {
+        return UART_ERROR;
+    }
+
+    channel = DMA_Claim(UART_GetTxDMARequest(pUSARTx));
+    if (channel == DMA_CHANNEL_NONE) {
+        return UART_BUSY;
+    }
+    pChannel = DMA_GetChannel(channel);
+
+    pUARTHandle->pTxSegments = pSegments;
+    pUARTHandle->TxSegmentCount = NumSegments;
+    pUARTHandle->TxSegmentIndex = 0;
+
+    // 1. Memory -> USART DR, byte wide, one request per TXE
+    dmaInit.DMA_PeripheralBaseAddr = (uint32_t)&pUSARTx->DR;
+    dmaInit.DMA_MemoryBaseAddr = 0;
+    dmaInit.DMA_DIR = DMA_DIR_PeripheralDST;
+    dmaInit.DMA_BufferSize = 0;
+    dmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInit.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    dmaInit.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    dmaInit.DMA_Mode = DMA_Mode_Normal;
+    dmaInit.DMA_Priority = DMA_Priority_Medium;
+    dmaInit.DMA_M2M = DMA_M2M_Disable;
+    dmaInit.DMA_IT = DMA_IT_TC | DMA_IT_TE;
+    DMA_Init(pChannel, &dmaInit);
+    DMA_SetCallbacks(channel, 0, UART_DMA_TxComplete, UART_DMA_TxError, pUARTHandle);
+
+    // 2. TC must be cleared by software when the DMA writes DR
+    BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TCIE_Pos) = 0;
+    pUSARTx->SR = (uint16_t)~USART_SR_TC;
+
+    (void)UART_DMA_StartNextSegment(pUARTHandle, pChannel);
+    pUARTHandle->TxDMAChannel = channel;
+    pUARTHandle->TxDMABusy = 1;
+    pUSARTx->CR3 |= USART_CR3_DMAT;
+    return UART_OK;
+}
+
+/**
+ * @brief  Starts continuous reception into a circular DMA buffer.
+ *         Received data is reported through UART_RxEventCallback on an idle
+ *         line, at half buffer and at buffer wrap, as at most two slices
+ *         pointing straight into pRxBuffer. The slices must be consumed before
+ *         the DMA comes round again.
+ *         The USART vector (UART_IRQHandler) and the DMA1 channel interrupt
+ *         of the RX request must run at the same NVIC priority.
+ * @param  pUARTHandle: pointer to an initialized UART handle.
+ * @param  pRxBuffer: circular receive area.
+ * @param  Size: size of pRxBuffer in bytes.
+ * @return UART_OK, UART_ERROR if Size is 0, or UART_BUSY if another
+ *         driver holds the channel.
+ */
+UART_Status UART_ReceiveToIdleDMA(UART_Handle_t *pUARTHandle, uint8_t *pRxBuffer, uint16_t Size) {
+    USART_TypeDef *pUSARTx = pUARTHandle->pUSARTx;
+    DMA_Channel_TypeDef *pChannel;
+    DMA_Init_t dmaInit;
+    uint8_t channel;
+
+    if (Size == 0) {
+        return UART_ERROR;
+    }
+
+    // Restart: give the channel back first
+    if (pUARTHandle->RxDMAChannel != DMA_CHANNEL_NONE) {
+        UART_StopReceiveDMA(pUARTHandle);
+    }
+
+    channel = DMA_Claim(UART_GetRxDMARequest(pUSARTx));
+    if (channel == DMA_CHANNEL_NONE) {
+        return UART_BUSY;
+    }
+    pChannel = DMA_GetChannel(channel);
+
+    pUARTHandle->pRxDMABuffer = pRxBuffer;
+    pUARTHandle->RxDMASize = Size;
+    pUARTHandle->RxDMAReadPos = 0;
+    pUARTHandle->RxDMAChannel = channel;
+
+    // 1. USART DR -> memory, circular, interrupts at half and full buffer
+    dmaInit.DMA_PeripheralBaseAddr = (uint32_t)&pUSARTx->DR;
+    dmaInit.DMA_MemoryBaseAddr = (uint32_t)pRxBuffer;
+    dmaInit.DMA_DIR = DMA_DIR_PeripheralSRC;
+    dmaInit.DMA_BufferSize = Size;
+    dmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInit.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    dmaInit.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    dmaInit.DMA_Mode = DMA_Mode_Circular;
+    dmaInit.DMA_Priority = DMA_Priority_High;
+    dmaInit.DMA_M2M = DMA_M2M_Disable;
+    dmaInit.DMA_IT = DMA_IT_TC | DMA_IT_HT | DMA_IT_TE;
+    DMA_Init(pChannel, &dmaInit);
+    DMA_SetCallbacks(channel, UART_DMA_RxEvent, UART_DMA_RxEvent, UART_DMA_RxError, pUARTHandle);
+    DMA_Cmd(pChannel, ENABLE);
+
+    // 2. Hand RX to the DMA; clear a stale IDLE flag (SR then DR read)
+    pUSARTx->CR1 &= ~USART_CR1_RXNEIE;
+    (void)pUSARTx->SR;
+    (void)pUSARTx->DR;
+    pUSARTx->CR3 |= USART_CR3_DMAR;
+    pUSARTx->CR1 |= USART_CR1_IDLEIE;
+
+    return UART_OK;
+}
+
+/**
+ * @brief  Stops circular DMA reception and releases the channel. Data not
+ *         yet reported is discarded.
+ * @param  pUARTHandle: handle passed to UART_ReceiveToIdleDMA.
+ */
+void UART_StopReceiveDMA(UART_Handle_t *pUARTHandle) {
+    USART_TypeDef *pUSARTx = pUARTHandle->pUSARTx;
+
+    pUSARTx->CR1 &= ~USART_CR1_IDLEIE;
+    pUSARTx->CR3 &= ~USART_CR3_DMAR;
+    DMA_Release(pUARTHandle->RxDMAChannel);
+    pUARTHandle->RxDMAChannel = DMA_CHANNEL_NONE;
+    pUARTHandle->pRxDMABuffer = 0;
+}
+
+/**
+ * @brief  Services RXNE, TXE and TC for the interrupt-driven ring buffers
+ *         and the end of a DMA transmission. Call from the USARTx vector.
+ * @param  pUARTHandle: handle of the interrupting USART.
+ */
+RAMFUNC void UART_IRQHandler(UART_Handle_t *pUARTHandle) {
+    USART_TypeDef *pUSARTx = pUARTHandle->pUSARTx;
+    uint32_t sr = pUSARTx->SR;
+    uint32_t cr1 = pUSARTx->CR1;
+
+    // 1. Receive: reading DR after SR clears RXNE and ORE together
+    if ((cr1 & USART_CR1_RXNEIE) && (sr & (USART_SR_RXNE | USART_SR_ORE))) {
+        uint8_t data = (uint8_t)(pUSARTx->DR & 0xFF);
+        uint16_t head = pUARTHandle->RxRing.Head;
+
+        if (sr & USART_SR_ORE) {
+            pUARTHandle->RxDropped++;
+            UART_ApplicationEventCallback(pUARTHandle, UART_EVENT_ORE);
+        }
+
+        if ((uint16_t)(head - pUARTHandle->RxRing.Tail) < UART_RX_BUFFER_SIZE) {
+            pUARTHandle->RxBuffer[head & (UART_RX_BUFFER_SIZE - 1U)] = data;
+            COMPILER_BARRIER();
+            pUARTHandle->RxRing.Head = (uint16_t)(head + 1U);
+        } else {
+            pUARTHandle->RxDropped++;
+            UART_ApplicationEventCallback(pUARTHandle, UART_EVENT_RX_FULL);
+        }
+    }
+
+    // 2. Idle line after a burst: flush the circular DMA buffer (SR then DR read clears IDLE)
+    if ((cr1 & USART_CR1_IDLEIE) && (sr & USART_SR_IDLE)) {
+        (void)pUSARTx->DR;
+        if (pUARTHandle->pRxDMABuffer) {
+            UART_RxDMA_Process(pUARTHandle);
+        }
+    }
+
+    // 3. Transmit: feed DR until the ring is empty, then wait for TC
+    if ((cr1 & USART_CR1_TXEIE) && (sr & USART_SR_TXE)) {
+        uint16_t tail = pUARTHandle->TxRing.Tail;
+
+        if (tail != pUARTHandle->TxRing.Head) {
+            COMPILER_BARRIER();
+            pUSARTx->DR = pUARTHandle->TxBuffer[tail & (UART_TX_BUFFER_SIZE - 1U)];
+            pUARTHandle->TxRing.Tail = (uint16_t)(tail + 1U);
+        } else {
+            BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TXEIE_Pos) = 0;
+            BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TCIE_Pos) = 1;
+        }
+    }
+
+    // 4. Transmission complete: shift register drained
+    if ((cr1 & USART_CR1_TCIE) && (sr & USART_SR_TC)) {
+        BITBAND_PERIPH(pUSARTx->CR1, USART_CR1_TCIE_Pos) = 0;
+        // TC is rc_w0; a plain write avoids clearing an RXNE that arrives mid read-modify-write
+        pUSARTx->SR = (uint16_t)~USART_SR_TC;
+        pUARTHandle->TxDMABusy = 0;
+        UART_ApplicationEventCallback(pUARTHandle, UART_EVENT_TX_CMPLT);
+    }
+}
+
+__attribute__((weak)) void UART_ApplicationEventCallback(UART_Handle_t *pUARTHandle, uint8_t AppEv) {
+    (void)pUARTHandle;
+    (void)AppEv;
+    // Weak implementation
 }
 
-void UART_IRQHandler(UART_Handle_t *pUARTHandle) {
+__attribute__((weak)) void UART_RxEventCallback(UART_Handle_t *pUARTHandle, const uint8_t *pData1, uint16_t Len1,
+                                                const uint8_t *pData2, uint16_t Len2) {
     (void)pUARTHandle;
-    // Implement generic IRQ handling if needed (e.g. ring buffer)
-    // For now, just a placeholder or basic callback
+    (void)pData1;
+    (void)Len1;
+    (void)pData2;
+    (void)Len2;
+    // Weak implementation
 }
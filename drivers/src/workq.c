@@ -0,0 +1,101 @@
+#include "workq.h"
+#include "lfqueue.h"
+#include "kernel.h"
+
+_Static_assert((WQ_QUEUE_SIZE & (WQ_QUEUE_SIZE - 1U)) == 0U, "WQ_QUEUE_SIZE must be a power of two");
+
+/*
+ * One MPSC queue of WQ_Work_t pointers per priority level; PendSV is the
+ * only consumer.
+ */
+static LFQ_MpscCell_t g_wq_cells[WQ_PRIO_LEVELS][WQ_QUEUE_SIZE];
+static LFQ_Mpsc_t g_wq_queues[WQ_PRIO_LEVELS];
+static volatile uint32_t g_wq_overflows;
+
+/**
+ * @brief  Sets up the queues, moves PendSV to the lowest priority, so
+ *         deferred work never delays an interrupt, and installs WQ_Run as
+ *         the PendSV hook. Nothing is dispatched before this call.
+ */
+void WQ_Init(void) {
+    for (uint32_t level = 0; level < WQ_PRIO_LEVELS; level++) {
+        LFQ_MpscInit(&g_wq_queues[level], g_wq_cells[level], WQ_QUEUE_SIZE);
+    }
+    g_wq_overflows = 0;
+
+    SCB->SHP[10] = 0xF0;    // PendSV (exception 14)
+    OS_SetPendSVHook(WQ_Run);
+}
+
+/**
+ * @brief  Prepares a work item. Must be called once before WQ_Post.
+ * @param  pWork: caller-owned item
+ * @param  pfnWork: runs from PendSV with pArg
+ * @param  Priority: 0 (first) .. WQ_PRIO_LEVELS-1, clamped
+ */
+void WQ_WorkInit(WQ_Work_t *pWork, WQ_Function_t pfnWork, void *pArg, uint8_t Priority) {
+    pWork->pfnWork = pfnWork;
+    pWork->pArg = pArg;
+    pWork->Pending = 0;
+    pWork->Priority = (Priority < WQ_PRIO_LEVELS) ? Priority : (uint8_t)(WQ_PRIO_LEVELS - 1U);
+}
+
+/**
+ * @brief  Queues a work item and pends PendSV. Callable from any context.
+ * @param  pWork: item prepared by WQ_WorkInit
+ * @return 1 if queued or already pending, 0 if its level was full
+ *         (counted by WQ_GetOverflows)
+ */
+uint8_t WQ_Post(WQ_Work_t *pWork) {
+    // Only the caller that flips Pending 0 -> 1 queues the item
+    do {
+        if (pWork->Pending) {
+            return 1;
+        }
+    } while (!LFQ_CompareAndSwap(&pWork->Pending, 0, 1));
+
+    if (!LFQ_MpscPut(&g_wq_queues[pWork->Priority], (uint32_t)pWork)) {
+        uint32_t overflows;
+
+        pWork->Pending = 0;
+        // Posts come from any priority: a plain ++ could lose a count
+        do {
+            overflows = g_wq_overflows;
+        } while (!LFQ_CompareAndSwap(&g_wq_overflows, overflows, overflows + 1U));
+        return 0;
+    }
+
+    SCB->ICSR = SCB_ICSR_PENDSVSET;
+    return 1;
+}
+
+/**
+ * @brief  Runs every queued item, highest level first. Called from PendSV
+ *         (installed by WQ_Init);
+ *         items posted meanwhile (also by the items themselves) run in the
+ *         same pass.
+ */
+void WQ_Run(void) {
+    uint32_t level = 0;
+    uint32_t item;
+
+    while (level < WQ_PRIO_LEVELS) {
+        if (LFQ_MpscGet(&g_wq_queues[level], &item)) {
+            WQ_Work_t *pWork = (WQ_Work_t *)item;
+
+            // Cleared first so the function (or an ISR) may post it again
+            pWork->Pending = 0;
+            pWork->pfnWork(pWork->pArg);
+            level = 0;
+        } else {
+            level++;
+        }
+    }
+}
+
+/**
+ * @brief  Number of posts rejected because a level was full
+ */
+uint32_t WQ_GetOverflows(void) {
+    return g_wq_overflows;
+}
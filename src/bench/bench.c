@@ -0,0 +1,59 @@
+#include <string.h>
+#include "bench.h"
+
+/**
+ * @brief  Sends a NUL-terminated string
+ */
+void Bench_PrintString(UART_Handle_t *pHuart, const char *pStr) {
+    UART_Transmit(pHuart, (uint8_t *)pStr, strlen(pStr));
+}
+
+/**
+ * @brief  Sends an unsigned decimal number
+ */
+void Bench_PrintU32(UART_Handle_t *pHuart, uint32_t Value) {
+    uint8_t digits[10];
+    uint8_t n = 0;
+
+    do {
+        digits[n++] = (uint8_t)('0' + (Value % 10U));
+        Value /= 10U;
+    } while (Value != 0);
+
+    while (n > 0) {
+        n--;
+        UART_Transmit(pHuart, &digits[n], 1);
+    }
+}
+
+/**
+ * @brief  Prints one result line: "<label>: min=.. avg=.. max=.. cycles (n=..)"
+ */
+void Bench_PrintStats(UART_Handle_t *pHuart, const char *pLabel, const DWT_CycleStats_t *pStats) {
+    Bench_PrintString(pHuart, pLabel);
+    Bench_PrintString(pHuart, ": min=");
+    Bench_PrintU32(pHuart, (pStats->Count != 0) ? pStats->Min : 0);
+    Bench_PrintString(pHuart, " avg=");
+    Bench_PrintU32(pHuart, DWT_CycleStatsAverage(pStats));
+    Bench_PrintString(pHuart, " max=");
+    Bench_PrintU32(pHuart, pStats->Max);
+    Bench_PrintString(pHuart, " cycles (n=");
+    Bench_PrintU32(pHuart, pStats->Count);
+    Bench_PrintString(pHuart, ")\r\n");
+}
+
+/**
+ * @brief  Runs every benchmark in turn. The kernel benchmark starts the
+ *         scheduler and therefore comes last and does not return.
+ */
+void Bench_RunAll(UART_Handle_t *pHuart) {
+    DWT_Init();
+    Bench_Boot(pHuart);
+    Bench_Irq(pHuart);
+    Bench_String(pHuart);
+    Bench_DmaCopy(pHuart);
+    Bench_DmaList(pHuart);
+    Bench_Spi(pHuart);
+    Bench_SpiBus(pHuart);
+    Bench_Kernel(pHuart);
+}
@@ -0,0 +1,26 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "uart.h"
+#include "dwt.h"
+
+/*
+ * On-target benchmarks, built into the firmware with -DBENCHMARKS=ON.
+ * Results are printed on the given UART in core clock cycles.
+ */
+void Bench_RunAll(UART_Handle_t *pHuart);
+void Bench_PrintStats(UART_Handle_t *pHuart, const char *pLabel, const DWT_CycleStats_t *pStats);
+void Bench_PrintString(UART_Handle_t *pHuart, const char *pStr);
+void Bench_PrintU32(UART_Handle_t *pHuart, uint32_t Value);
+
+// Individual benchmarks
+void Bench_Boot(UART_Handle_t *pHuart);
+void Bench_Irq(UART_Handle_t *pHuart);
+void Bench_String(UART_Handle_t *pHuart);
+void Bench_DmaCopy(UART_Handle_t *pHuart);
+void Bench_DmaList(UART_Handle_t *pHuart);
+void Bench_Spi(UART_Handle_t *pHuart);
+void Bench_SpiBus(UART_Handle_t *pHuart);
+void Bench_Kernel(UART_Handle_t *pHuart);
+
+#endif // BENCH_H
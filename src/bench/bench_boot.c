@@ -0,0 +1,31 @@
+#include "bench.h"
+#include "boot.h"
+
+// Helper to print one boot phase: "<label>: <cycles> cycles"
+static void Bench_BootPhase(UART_Handle_t *pHuart, const char *pLabel, uint32_t Cycles) {
+    Bench_PrintString(pHuart, pLabel);
+    Bench_PrintString(pHuart, ": ");
+    Bench_PrintU32(pHuart, Cycles);
+    Bench_PrintString(pHuart, " cycles\r\n");
+}
+
+/**
+ * @brief  Time from reset to main, per C runtime init phase, as recorded by
+ *         the reset handler. The clock phase is counted at 8MHz (HSI), the
+ *         others at 72MHz unless SystemInit fell back to HSI.
+ */
+void Bench_Boot(UART_Handle_t *pHuart) {
+    const BOOT_Profile_t *pProfile = BOOT_GetProfile();
+
+    if (pProfile == 0) {
+        Bench_PrintString(pHuart, "boot profile: not recorded\r\n");
+        return;
+    }
+
+    Bench_PrintString(pHuart, "boot profile\r\n");
+    Bench_BootPhase(pHuart, "  SystemInit (HSI cycles)", pProfile->ClockCycles);
+    Bench_BootPhase(pHuart, "  .data copy", pProfile->DataCycles - pProfile->ClockCycles);
+    Bench_BootPhase(pHuart, "  .ramfunc copy", pProfile->RamfuncCycles - pProfile->DataCycles);
+    Bench_BootPhase(pHuart, "  .bss zero", pProfile->BssCycles - pProfile->RamfuncCycles);
+    Bench_BootPhase(pHuart, "  reset to main", pProfile->MainCycles);
+}
@@ -0,0 +1,125 @@
+#include <string.h>
+#include "bench.h"
+#include "dmacopy.h"
+
+#define BENCH_DMACOPY_REPEAT    4U
+#define BENCH_DMACOPY_MAX       2048U
+#define BENCH_DMACOPY_CALIBRATE 1000U   // Spin iterations timed without DMA
+#define BENCH_DMACOPY_SPIN_MAX  1000000U
+
+static const uint16_t g_dmacopy_sizes[] = {8, 16, 32, 64, 128, 256, 512, 1024, 2048};
+
+static uint8_t g_dmacopy_src[BENCH_DMACOPY_MAX + 4U] __attribute__((aligned(4)));
+static uint8_t g_dmacopy_dst[BENCH_DMACOPY_MAX + 4U] __attribute__((aligned(4)));
+static DMACPY_Request_t g_dmacopy_req;
+static volatile uint8_t g_dmacopy_done;
+
+static void Bench_DmaCopyDone(DMACPY_Request_t *pReq, void *pContext) {
+    (void)pReq;
+    (void)pContext;
+    g_dmacopy_done = 1;
+}
+
+// Helper to count idle-loop iterations until the copy has completed
+static uint32_t Bench_DmaCopySpin(uint32_t Max) {
+    uint32_t n = 0;
+    while (!g_dmacopy_done && (n < Max)) {
+        n++;
+    }
+    return n;
+}
+
+/*
+ * Helper to measure one size: the CPU copy, and for the DMA copy its wall
+ * time and the CPU cycles it took (setup, interrupt, bus contention), that
+ * is wall time minus what the idle loop still got done.
+ */
+static void Bench_DmaCopyRun(uint8_t *pDst, const uint8_t *pSrc, uint32_t Len, uint32_t SpinCost,
+                             DWT_CycleStats_t *pCpu, DWT_CycleStats_t *pWall, DWT_CycleStats_t *pBusy) {
+    uint32_t start, wall, idle;
+
+    for (uint32_t r = 0; r < BENCH_DMACOPY_REPEAT; r++) {
+        start = cycles_now();
+        (void)memcpy(pDst, pSrc, Len);
+        DWT_CycleStatsAdd(pCpu, cycles_now() - start);
+
+        g_dmacopy_done = 0;
+        start = cycles_now();
+        (void)DMACPY_MemcpyAsync(&g_dmacopy_req, pDst, pSrc, Len, Bench_DmaCopyDone, 0);
+        idle = (Bench_DmaCopySpin(BENCH_DMACOPY_SPIN_MAX) * SpinCost) >> 8;
+        wall = cycles_now() - start;
+        DWT_CycleStatsAdd(pWall, wall);
+        DWT_CycleStatsAdd(pBusy, (wall > idle) ? (wall - idle) : 0U);
+    }
+}
+
+/**
+ * @brief  DMA memory-to-memory copy against memcpy for growing sizes, with
+ *         aligned and misaligned buffers. The DMA CPU cost is measured with
+ *         an idle loop running during the transfer. The smallest aligned
+ *         size where the DMA costs the CPU less than memcpy becomes the
+ *         copy engine's CPU threshold.
+ */
+void Bench_DmaCopy(UART_Handle_t *pHuart) {
+    DWT_CycleStats_t cpu, wall, busy;
+    uint32_t start, spin_cost, saved;
+
+    if (DMACPY_Init() != DMACPY_OK) {
+        Bench_PrintString(pHuart, "dma copy: no free DMA channel\r\n");
+        return;
+    }
+    saved = DMACPY_GetCpuThreshold();
+    DMACPY_SetCpuThreshold(0);
+
+    // Cycles per idle-loop iteration, 24.8 fixed point
+    g_dmacopy_done = 0;
+    start = cycles_now();
+    (void)Bench_DmaCopySpin(BENCH_DMACOPY_CALIBRATE);
+    spin_cost = ((cycles_now() - start) << 8) / BENCH_DMACOPY_CALIBRATE;
+
+    for (uint8_t misaligned = 0; misaligned < 2U; misaligned++) {
+        uint32_t crossover = 0;
+
+        Bench_PrintString(pHuart, misaligned ? "dma copy, dst+1 (byte items): " : "dma copy, aligned (word items): ");
+        Bench_PrintString(pHuart, "size\tmemcpy\tdma wall\tdma cpu\r\n");
+
+        for (uint32_t s = 0; s < sizeof(g_dmacopy_sizes) / sizeof(g_dmacopy_sizes[0]); s++) {
+            uint32_t len = g_dmacopy_sizes[s];
+
+            DWT_CycleStatsReset(&cpu);
+            DWT_CycleStatsReset(&wall);
+            DWT_CycleStatsReset(&busy);
+            Bench_DmaCopyRun(&g_dmacopy_dst[misaligned], g_dmacopy_src, len, spin_cost, &cpu, &wall, &busy);
+
+            Bench_PrintString(pHuart, "  ");
+            Bench_PrintU32(pHuart, len);
+            Bench_PrintString(pHuart, "\t");
+            Bench_PrintU32(pHuart, cpu.Min);
+            Bench_PrintString(pHuart, "\t");
+            Bench_PrintU32(pHuart, wall.Min);
+            Bench_PrintString(pHuart, "\t");
+            Bench_PrintU32(pHuart, busy.Min);
+            Bench_PrintString(pHuart, "\r\n");
+
+            if ((crossover == 0U) && (busy.Min < cpu.Min)) {
+                crossover = len;
+            }
+        }
+
+        Bench_PrintString(pHuart, "  DMA saves CPU from ");
+        if (crossover != 0U) {
+            Bench_PrintU32(pHuart, crossover);
+            Bench_PrintString(pHuart, " bytes\r\n");
+        } else {
+            Bench_PrintString(pHuart, "(never in range)\r\n");
+        }
+        if (!misaligned) {
+            saved = (crossover != 0U) ? crossover : (BENCH_DMACOPY_MAX + 1U);
+        }
+    }
+
+    DMACPY_SetCpuThreshold(saved);
+    Bench_PrintString(pHuart, "  CPU threshold: ");
+    Bench_PrintU32(pHuart, saved);
+    Bench_PrintString(pHuart, " bytes\r\n");
+}
@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "dmalist.h"
+#include "timer.h"
+
+#define BENCH_DMAL_NODES        4U
+#define BENCH_DMAL_SAMPLES      32U     // Timer stamps per node
+
+/*
+ * Each node is a separate buffer, so the chain is not contiguous in memory.
+ * The DMA copies TIM4->CNT (counting at the timer clock) into them as fast
+ * as it can; consecutive stamps are one item apart within a node and one
+ * item plus the chaining gap across a node boundary.
+ */
+static uint16_t g_dmal_buf0[BENCH_DMAL_SAMPLES];
+static uint16_t g_dmal_buf1[BENCH_DMAL_SAMPLES];
+static uint16_t g_dmal_buf2[BENCH_DMAL_SAMPLES];
+static uint16_t g_dmal_buf3[BENCH_DMAL_SAMPLES];
+static uint8_t *const g_dmal_buffers[BENCH_DMAL_NODES] = {
+    (uint8_t *)g_dmal_buf0, (uint8_t *)g_dmal_buf1, (uint8_t *)g_dmal_buf2, (uint8_t *)g_dmal_buf3,
+};
+static DMAL_Node_t g_dmal_nodes[BENCH_DMAL_NODES];
+static DMAL_List_t g_dmal_list;
+static TIM_Handle_t g_dmal_tim;
+
+// Helper to get sample Index of node Node
+static uint16_t Bench_DmaListSample(uint32_t Node, uint32_t Index) {
+    return ((const uint16_t *)g_dmal_buffers[Node])[Index];
+}
+
+/**
+ * @brief  Gap a software-chained DMA list leaves between two nodes, in timer
+ *         clocks (72MHz, the core clock, with the default clock tree).
+ *         A memory-to-memory chain samples a free-running timer into four
+ *         separate buffers; the step between stamps inside a node is the
+ *         per-item cost, the step across a boundary adds the interrupt
+ *         that reprograms the channel.
+ */
+void Bench_DmaList(UART_Handle_t *pHuart) {
+    DMA_Init_t dmaInit;
+    DWT_CycleStats_t item, gap;
+
+    g_dmal_tim.pTIMx = TIM4;
+    g_dmal_tim.BaseConfig.Prescaler = 0;
+    g_dmal_tim.BaseConfig.Period = 0xFFFF;
+    g_dmal_tim.BaseConfig.CounterMode = TIM_COUNTERMODE_UP;
+    g_dmal_tim.BaseConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+    g_dmal_tim.BaseConfig.SlaveMode = TIM_SLAVEMODE_DISABLE;
+    g_dmal_tim.BaseConfig.InputTrigger = TIM_TS_ITR0;
+    TIM_Base_Init(&g_dmal_tim);
+
+    dmaInit.DMA_PeripheralBaseAddr = (uint32_t)&TIM4->CNT;
+    dmaInit.DMA_MemoryBaseAddr = 0;
+    dmaInit.DMA_DIR = DMA_DIR_PeripheralSRC;
+    dmaInit.DMA_BufferSize = 0;
+    dmaInit.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    dmaInit.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    dmaInit.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    dmaInit.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+    dmaInit.DMA_Mode = DMA_Mode_Normal;
+    dmaInit.DMA_Priority = DMA_Priority_VeryHigh;
+    dmaInit.DMA_M2M = DMA_M2M_Enable;
+    dmaInit.DMA_IT = 0;
+    if (DMAL_Init(&g_dmal_list, DMA_REQ_MEM2MEM, &dmaInit, 0, 0, 0) != DMAL_OK) {
+        Bench_PrintString(pHuart, "dma list: no free DMA channel\r\n");
+        return;
+    }
+
+    DMAL_BuildChain(g_dmal_nodes, g_dmal_buffers, BENCH_DMAL_NODES, BENCH_DMAL_SAMPLES);
+    TIM_Base_Start(TIM4);
+    (void)DMAL_Start(&g_dmal_list, &g_dmal_nodes[0]);
+    while (DMAL_IsRunning(&g_dmal_list)) {
+    }
+    TIM_Base_Stop(TIM4);
+    DMAL_DeInit(&g_dmal_list);
+
+    DWT_CycleStatsReset(&item);
+    DWT_CycleStatsReset(&gap);
+    for (uint32_t node = 0; node < BENCH_DMAL_NODES; node++) {
+        for (uint32_t i = 1; i < BENCH_DMAL_SAMPLES; i++) {
+            DWT_CycleStatsAdd(&item, (uint16_t)(Bench_DmaListSample(node, i) - Bench_DmaListSample(node, i - 1U)));
+        }
+        if (node > 0U) {
+            DWT_CycleStatsAdd(&gap, (uint16_t)(Bench_DmaListSample(node, 0) -
+                                               Bench_DmaListSample(node - 1U, BENCH_DMAL_SAMPLES - 1U)));
+        }
+    }
+
+    Bench_PrintStats(pHuart, "dma list item step (timer clocks)", &item);
+    Bench_PrintStats(pHuart, "dma list node boundary step (timer clocks)", &gap);
+    Bench_PrintString(pHuart, "  chaining gap: ");
+    Bench_PrintU32(pHuart, DWT_CycleStatsAverage(&gap) - DWT_CycleStatsAverage(&item));
+    Bench_PrintString(pHuart, " timer clocks\r\n");
+}
@@ -0,0 +1,248 @@
+#include "bench.h"
+#include "nvic.h"
+#include "timer.h"
+#include "systick.h"
+#include "rcc.h"
+
+#define BENCH_IRQ_SAMPLES       256U
+#define BENCH_IRQ_BINS          16U     // Histogram bins above the minimum, last one open-ended
+#define BENCH_IRQ_BIN_CYCLES    2U
+#define BENCH_IRQ_BAR_MAX       40U
+#define BENCH_IRQ_PRIORITY      8U      // Measured interrupts
+#define BENCH_IRQ_LOAD_PRIORITY 6U      // Background load, preempts the measured ones
+#define BENCH_IRQ_LOAD_HZ       20000U
+#define BENCH_IRQ_LOAD_SPIN     50U     // Busy loop iterations per load interrupt
+
+/*
+ * Measured paths. The vectors below are only defined in BENCHMARKS builds,
+ * where these lines belong to the benchmark.
+ *  - EXTI0: software interrupt event register (EXTI->SWIER), handler in flash
+ *  - EXTI1: NVIC software trigger (NVIC->STIR), handler in flash
+ *  - EXTI2: NVIC software trigger, handler in SRAM (RAMFUNC)
+ * TIM4 provides the background interrupt load.
+ */
+#define BENCH_PATH_EXTI_SWIER   0U
+#define BENCH_PATH_STIR_FLASH   1U
+#define BENCH_PATH_STIR_RAM     2U
+#define BENCH_PATH_COUNT        3U
+
+static const char *const g_path_names[BENCH_PATH_COUNT] = {
+    "EXTI SWIER, flash handler",
+    "NVIC STIR, flash handler",
+    "NVIC STIR, RAM handler",
+};
+
+static const uint8_t g_path_irqs[BENCH_PATH_COUNT] = {
+    IRQ_NO_EXTI0, IRQ_NO_EXTI1, IRQ_NO_EXTI2
+};
+
+static volatile uint8_t g_use_systick;      // No DWT cycle counter (e.g. QEMU): time with SysTick
+static volatile uint32_t g_entry_stamp;
+static volatile uint32_t g_exit_stamp;
+static volatile uint8_t g_irq_done;
+static uint16_t g_latency[BENCH_IRQ_SAMPLES];
+static TIM_Handle_t g_load_tim;
+
+/*
+ * Timestamp in core cycles. SysTick counts HCLK cycles too, but down and
+ * modulo LOAD + 1, which Bench_Elapsed accounts for.
+ */
+static inline __attribute__((always_inline)) uint32_t Bench_Stamp(void) {
+    return g_use_systick ? (SysTick->LOAD - SysTick->VAL) : cycles_now();
+}
+
+// Helper to get the cycles between two stamps
+static uint32_t Bench_Elapsed(uint32_t start, uint32_t end) {
+    uint32_t elapsed = end - start;
+
+    if (g_use_systick && (int32_t)elapsed < 0) {
+        elapsed += SysTick->LOAD + 1U;
+    }
+    return elapsed;
+}
+
+#ifdef BENCHMARKS
+void v_v_exti0_handler(void) {
+    g_entry_stamp = Bench_Stamp();
+    EXTI->PR = (1U << 0);
+    g_irq_done = 1;
+    g_exit_stamp = Bench_Stamp();
+}
+
+void v_v_exti1_handler(void) {
+    g_entry_stamp = Bench_Stamp();
+    g_irq_done = 1;
+    g_exit_stamp = Bench_Stamp();
+}
+
+// Runs from SRAM; the vector holds its SRAM address
+RAMFUNC void v_v_exti2_handler(void) {
+    g_entry_stamp = Bench_Stamp();
+    g_irq_done = 1;
+    g_exit_stamp = Bench_Stamp();
+}
+
+// Background load: a short busy handler at a higher priority than the measured ones
+void v_v_tim4_handler(void) {
+    TIM4->SR = ~TIM_SR_UIF;
+    for (volatile uint32_t i = 0; i < BENCH_IRQ_LOAD_SPIN; i++) {
+    }
+}
+#endif
+
+// Helper to raise one measured interrupt and wait until its handler has run
+static void Bench_IrqTrigger(uint8_t Path, uint32_t *pStart) {
+    g_irq_done = 0;
+    if (Path == BENCH_PATH_EXTI_SWIER) {
+        *pStart = Bench_Stamp();
+        EXTI->SWIER = (1U << 0);
+    } else {
+        *pStart = Bench_Stamp();
+        NVIC->STIR = g_path_irqs[Path];
+    }
+    while (!g_irq_done) {
+    }
+}
+
+// Helper to print the latency histogram: bins of BENCH_IRQ_BIN_CYCLES above Min
+static void Bench_IrqHistogram(UART_Handle_t *pHuart, uint32_t Count, uint32_t Min) {
+    uint32_t bins[BENCH_IRQ_BINS] = {0};
+    uint32_t peak = 0;
+
+    for (uint32_t i = 0; i < Count; i++) {
+        uint32_t bin = (g_latency[i] - Min) / BENCH_IRQ_BIN_CYCLES;
+        bins[(bin < BENCH_IRQ_BINS) ? bin : (BENCH_IRQ_BINS - 1U)]++;
+    }
+    for (uint32_t b = 0; b < BENCH_IRQ_BINS; b++) {
+        if (bins[b] > peak) peak = bins[b];
+    }
+
+    for (uint32_t b = 0; b < BENCH_IRQ_BINS; b++) {
+        if (bins[b] == 0) {
+            continue;
+        }
+        Bench_PrintString(pHuart, "    ");
+        Bench_PrintU32(pHuart, Min + (b * BENCH_IRQ_BIN_CYCLES));
+        Bench_PrintString(pHuart, (b == BENCH_IRQ_BINS - 1U) ? "+\t" : "\t");
+        Bench_PrintU32(pHuart, bins[b]);
+        Bench_PrintString(pHuart, "\t");
+        for (uint32_t n = (bins[b] * BENCH_IRQ_BAR_MAX + peak - 1U) / peak; n > 0; n--) {
+            Bench_PrintString(pHuart, "#");
+        }
+        Bench_PrintString(pHuart, "\r\n");
+    }
+}
+
+// Helper to measure one path; latencies are also kept in g_latency for the histogram
+static void Bench_IrqRun(uint8_t Path, DWT_CycleStats_t *pLatency, DWT_CycleStats_t *pDuration) {
+    uint32_t start;
+
+    DWT_CycleStatsReset(pLatency);
+    DWT_CycleStatsReset(pDuration);
+
+    NVIC_SetPriority(g_path_irqs[Path], BENCH_IRQ_PRIORITY);
+    NVIC_ClearPending(g_path_irqs[Path]);
+    NVIC_EnableIRQ(g_path_irqs[Path]);
+
+    for (uint32_t i = 0; i < BENCH_IRQ_SAMPLES; i++) {
+        uint32_t cycles;
+
+        Bench_IrqTrigger(Path, &start);
+        cycles = Bench_Elapsed(start, g_entry_stamp);
+        g_latency[i] = (uint16_t)((cycles < 0xFFFFU) ? cycles : 0xFFFFU);
+        DWT_CycleStatsAdd(pLatency, cycles);
+        DWT_CycleStatsAdd(pDuration, Bench_Elapsed(g_entry_stamp, g_exit_stamp));
+    }
+
+    NVIC_DisableIRQ(g_path_irqs[Path]);
+}
+
+// Helper to print latency, duration, jitter and the histogram of one run
+static void Bench_IrqReport(UART_Handle_t *pHuart, uint8_t Path,
+                            const DWT_CycleStats_t *pLatency, const DWT_CycleStats_t *pDuration) {
+    Bench_PrintString(pHuart, "  ");
+    Bench_PrintString(pHuart, g_path_names[Path]);
+    Bench_PrintString(pHuart, "\r\n");
+    Bench_PrintStats(pHuart, "    entry latency", pLatency);
+    Bench_PrintStats(pHuart, "    handler duration", pDuration);
+    Bench_PrintString(pHuart, "    jitter (max-min): ");
+    Bench_PrintU32(pHuart, pLatency->Max - pLatency->Min);
+    Bench_PrintString(pHuart, " cycles\r\n");
+    Bench_IrqHistogram(pHuart, BENCH_IRQ_SAMPLES, pLatency->Min);
+}
+
+// Helper to start or stop the TIM4 background interrupt load
+static void Bench_IrqLoad(uint8_t EnorDi) {
+    if (EnorDi == ENABLE) {
+        g_load_tim.pTIMx = TIM4;
+        g_load_tim.BaseConfig.Prescaler = TIM_CalcPrescaler(TIM4, 1000000U);
+        g_load_tim.BaseConfig.Period = (uint16_t)((1000000U / BENCH_IRQ_LOAD_HZ) - 1U);
+        g_load_tim.BaseConfig.CounterMode = TIM_COUNTERMODE_UP;
+        g_load_tim.BaseConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+        g_load_tim.BaseConfig.SlaveMode = TIM_SLAVEMODE_DISABLE;
+        g_load_tim.BaseConfig.InputTrigger = TIM_TS_ITR0;
+        TIM_Base_Init(&g_load_tim);
+        NVIC_SetPriority(IRQ_NO_TIM4, BENCH_IRQ_LOAD_PRIORITY);
+        NVIC_EnableIRQ(IRQ_NO_TIM4);
+        TIM_Base_Start_IT(TIM4);
+    } else {
+        TIM_Base_Stop_IT(TIM4);
+        NVIC_DisableIRQ(IRQ_NO_TIM4);
+        NVIC_ClearPending(IRQ_NO_TIM4);
+    }
+}
+
+/**
+ * @brief  Interrupt entry latency (trigger write -> first handler
+ *         instruction), handler duration and jitter for each path, with
+ *         every legal flash wait-state setting at the current HCLK and
+ *         with/without a background interrupt load. Each run ends with a
+ *         latency histogram.
+ *         Without a DWT cycle counter (QEMU) SysTick is used for timing;
+ *         QEMU is not cycle-accurate, so those figures only track
+ *         regressions in instruction count (run it with -icount).
+ */
+void Bench_Irq(UART_Handle_t *pHuart) {
+    DWT_CycleStats_t latency, duration;
+    RCC_Clocks_t clocks;
+    uint32_t start, acr, min_ws;
+
+    // A counter that does not move means no DWT (e.g. QEMU); delay_us would spin on it forever
+    start = cycles_now();
+    for (volatile uint32_t i = 0; i < 100U; i++) {
+    }
+    g_use_systick = (cycles_now() == start);
+
+    EXTI->IMR |= (1U << 0);
+
+    RCC_GetClocksFreq(&clocks);
+    min_ws = (clocks.HCLK_Frequency <= 24000000U) ? 0U : (clocks.HCLK_Frequency <= 48000000U) ? 1U : 2U;
+    acr = FLASH->ACR;
+
+    for (uint32_t ws = min_ws; ws <= 2U; ws++) {
+        // More wait states than HCLK needs is always safe
+        FLASH->ACR = (acr & ~FLASH_ACR_LATENCY_Msk) | ws;
+
+        for (uint8_t load = 0; load < 2U; load++) {
+            Bench_PrintString(pHuart, "irq latency, flash wait states=");
+            Bench_PrintU32(pHuart, ws);
+            Bench_PrintString(pHuart, load ? ", TIM4 load on" : ", no load");
+            Bench_PrintString(pHuart, g_use_systick ? " (SysTick timing)\r\n" : "\r\n");
+
+            for (uint8_t path = 0; path < BENCH_PATH_COUNT; path++) {
+                if (load) {
+                    Bench_IrqLoad(ENABLE);
+                }
+                Bench_IrqRun(path, &latency, &duration);
+                if (load) {
+                    Bench_IrqLoad(DISABLE);
+                }
+                // Printed with the load stopped so the blocking UART output is not slowed by it
+                Bench_IrqReport(pHuart, path, &latency, &duration);
+            }
+        }
+    }
+
+    FLASH->ACR = acr;
+    EXTI->IMR &= ~(1U << 0);
+}
@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "kernel.h"
+
+#define BENCH_KERNEL_ROUNDS     1000U
+#define BENCH_STACK_WORDS       128U
+
+static OS_Task_t g_ping_task, g_pong_task;
+static uint32_t g_ping_stack[BENCH_STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t g_pong_stack[BENCH_STACK_WORDS] __attribute__((aligned(8)));
+static OS_Sem_t g_pong_sem;
+static volatile uint32_t g_give_time;
+static DWT_CycleStats_t g_switch_stats;
+static UART_Handle_t *g_bench_uart;
+
+// Higher priority: wakes on each give and records give -> running
+static void Bench_PongTask(void *pArg) {
+    (void)pArg;
+    while (1) {
+        (void)OS_SemTake(&g_pong_sem, OS_WAIT_FOREVER);
+        DWT_CycleStatsAdd(&g_switch_stats, cycles_now() - g_give_time);
+    }
+}
+
+// Lower priority: every give preempts it in favour of the pong task
+static void Bench_PingTask(void *pArg) {
+    uint32_t i;
+    (void)pArg;
+
+    DWT_CycleStatsReset(&g_switch_stats);
+    for (i = 0; i < BENCH_KERNEL_ROUNDS; i++) {
+        g_give_time = cycles_now();
+        OS_SemGive(&g_pong_sem);
+    }
+    Bench_PrintStats(g_bench_uart, "kernel sem give -> task switch", &g_switch_stats);
+
+    while (1) {
+        OS_Delay(1000);
+    }
+}
+
+/**
+ * @brief  Context-switch cost: a semaphore given by a low-priority task
+ *         wakes a higher-priority one; the time from the give to the woken
+ *         task running covers the scheduler, PendSV and the full context
+ *         save/restore. Starts the kernel, does not return.
+ */
+void Bench_Kernel(UART_Handle_t *pHuart) {
+    g_bench_uart = pHuart;
+    OS_SemInit(&g_pong_sem, 0);
+    (void)OS_TaskCreate(&g_pong_task, Bench_PongTask, 0, g_pong_stack, BENCH_STACK_WORDS, 1);
+    (void)OS_TaskCreate(&g_ping_task, Bench_PingTask, 0, g_ping_stack, BENCH_STACK_WORDS, 2);
+    OS_Start();
+}
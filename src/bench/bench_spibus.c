@@ -0,0 +1,81 @@
+#include "bench.h"
+#include "spibus.h"
+#include "nvic.h"
+
+#define BENCH_SPIBUS_REQUESTS   16U
+#define BENCH_SPIBUS_BYTES      16U
+
+static uint8_t g_spibus_tx[BENCH_SPIBUS_BYTES];
+static SPIBUS_t g_spibus;
+static SPIBUS_Device_t g_spibus_devs[2];
+static SPIBUS_Request_t g_spibus_reqs[BENCH_SPIBUS_REQUESTS];
+
+// Helper to queue all requests (alternating devices or not) and time until the last one is done
+static uint32_t Bench_SpiBusRun(uint8_t Alternate) {
+    uint32_t start = cycles_now();
+
+    for (uint32_t i = 0; i < BENCH_SPIBUS_REQUESTS; i++) {
+        const SPIBUS_Device_t *pDevice = &g_spibus_devs[Alternate ? (i & 1U) : 0U];
+        (void)SPIBUS_TransferAsync(&g_spibus, &g_spibus_reqs[i], pDevice, g_spibus_tx, 0,
+                                   BENCH_SPIBUS_BYTES, 0, 0);
+    }
+    while (SPIBUS_IsBusy(&g_spibus_reqs[BENCH_SPIBUS_REQUESTS - 1U])) {
+    }
+    return (cycles_now() - start) / BENCH_SPIBUS_REQUESTS;
+}
+
+/**
+ * @brief  Device switching on a shared SPI1 bus: per-transaction cost of
+ *         16-byte transactions to one device, and alternating between two
+ *         devices (mode 0 and mode 3, same prescaler and frame size, so
+ *         the difference is the CR1 switch). Also times SPI_Init,
+ *         the read-modify-write the precomputed CR1 store replaces.
+ */
+void Bench_SpiBus(UART_Handle_t *pHuart) {
+    SPI_Config_t spiConfig;
+    DWT_CycleStats_t init;
+    uint32_t same, alternate;
+
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN;
+    spiConfig.SPI_Direction = SPI_Direction_2Lines_FullDuplex;
+    spiConfig.SPI_Mode = SPI_Mode_Master;
+    spiConfig.SPI_DataSize = SPI_DataSize_8b;
+    spiConfig.SPI_CPOL = SPI_CPOL_Low;
+    spiConfig.SPI_CPHA = SPI_CPHA_1Edge;
+    spiConfig.SPI_NSS = SPI_NSS_Soft;
+    spiConfig.SPI_BaudRatePrescaler = SPI_BaudRatePrescaler_4;
+    spiConfig.SPI_FirstBit = SPI_FirstBit_MSB;
+
+    DWT_CycleStatsReset(&init);
+    for (uint32_t run = 0; run < 8U; run++) {
+        uint32_t start = cycles_now();
+        SPI_Init(SPI1, &spiConfig);
+        DWT_CycleStatsAdd(&init, cycles_now() - start);
+    }
+
+    SPIBUS_DeviceInit(&g_spibus_devs[0], &spiConfig, 0, 0, 0);
+    spiConfig.SPI_CPOL = SPI_CPOL_High;
+    spiConfig.SPI_CPHA = SPI_CPHA_2Edge;
+    SPIBUS_DeviceInit(&g_spibus_devs[1], &spiConfig, 0, 0, 0);
+
+    if (SPIBUS_Init(&g_spibus, SPI1) != SPIBUS_OK) {
+        Bench_PrintString(pHuart, "spi bus: channels taken\r\n");
+        return;
+    }
+    // SPIBUS_Done must not preempt the queue's BASEPRI critical sections
+    NVIC_SetPriority((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + g_spibus.Spi.RxChannel - 1U), NVIC_CRITICAL_PRIORITY);
+    NVIC_SetPriority((uint8_t)(IRQ_NO_DMA1_CHANNEL1 + g_spibus.Spi.TxChannel - 1U), NVIC_CRITICAL_PRIORITY);
+
+    same = Bench_SpiBusRun(0);
+    alternate = Bench_SpiBusRun(1);
+    SPIBUS_DeInit(&g_spibus);
+
+    Bench_PrintStats(pHuart, "SPI_Init reconfiguration", &init);
+    Bench_PrintString(pHuart, "spi bus 16-byte transaction, same device: ");
+    Bench_PrintU32(pHuart, same);
+    Bench_PrintString(pHuart, " cycles\r\nspi bus 16-byte transaction, alternating devices: ");
+    Bench_PrintU32(pHuart, alternate);
+    Bench_PrintString(pHuart, " cycles (");
+    Bench_PrintU32(pHuart, g_spibus.Switches);
+    Bench_PrintString(pHuart, " CR1 switches)\r\n");
+}
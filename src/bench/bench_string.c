@@ -0,0 +1,154 @@
+#include <string.h>
+#include "bench.h"
+
+#define BENCH_STRING_REPEAT     8U
+#define BENCH_STRING_MAX        1024U
+
+static const uint16_t g_string_sizes[] = {4, 16, 64, 256, 1024};
+
+// Destination/source byte offsets from word alignment
+static const uint8_t g_string_offsets[][2] = {
+    {0, 0}, {1, 1}, {0, 1}, {3, 0},
+};
+
+static uint8_t g_string_src[BENCH_STRING_MAX + 4U] __attribute__((aligned(4)));
+static uint8_t g_string_dst[BENCH_STRING_MAX + 4U] __attribute__((aligned(4)));
+static volatile uint32_t g_string_sink;    // Keeps the memcmp/strlen results alive
+
+/*
+ * Reference loops. The volatile destination keeps GCC from turning them
+ * into calls to the routines they are compared with.
+ */
+static void Bench_NaiveCopy(volatile uint8_t *pDst, const uint8_t *pSrc, uint32_t Len) {
+    while (Len--) {
+        *pDst++ = *pSrc++;
+    }
+}
+
+static void Bench_NaiveSet(volatile uint8_t *pDst, uint8_t Value, uint32_t Len) {
+    while (Len--) {
+        *pDst++ = Value;
+    }
+}
+
+static int Bench_NaiveCompare(const volatile uint8_t *pA, const uint8_t *pB, uint32_t Len) {
+    while (Len--) {
+        if (*pA != *pB) {
+            return (int)*pA - (int)*pB;
+        }
+        pA++;
+        pB++;
+    }
+    return 0;
+}
+
+static uint32_t Bench_NaiveLen(const volatile char *pStr) {
+    uint32_t len = 0;
+    while (pStr[len] != '\0') {
+        len++;
+    }
+    return len;
+}
+
+// Helper to print cycles per byte with two decimals
+static void Bench_StringPerByte(UART_Handle_t *pHuart, uint32_t Cycles, uint32_t Len) {
+    uint32_t hundredths = (Cycles * 100U) / Len;
+
+    Bench_PrintU32(pHuart, hundredths / 100U);
+    Bench_PrintString(pHuart, (hundredths % 100U < 10U) ? ".0" : ".");
+    Bench_PrintU32(pHuart, hundredths % 100U);
+}
+
+// Helper to print one "<label> <size> <optimised> <naive>" row in cycles per byte
+static void Bench_StringRow(UART_Handle_t *pHuart, const char *pLabel, uint32_t Len,
+                            uint32_t Fast, uint32_t Naive) {
+    Bench_PrintString(pHuart, pLabel);
+    Bench_PrintU32(pHuart, Len);
+    Bench_PrintString(pHuart, "\t");
+    Bench_StringPerByte(pHuart, Fast, Len);
+    Bench_PrintString(pHuart, "\t");
+    Bench_StringPerByte(pHuart, Naive, Len);
+    Bench_PrintString(pHuart, "\r\n");
+}
+
+/**
+ * @brief  memcpy, memcmp, memset and strlen (src/libc/string.c) against plain byte
+ *         loops, in cycles per byte, for several sizes and dst/src
+ *         alignments. Each figure is the best of BENCH_STRING_REPEAT runs.
+ */
+void Bench_String(UART_Handle_t *pHuart) {
+    DWT_CycleStats_t fast, naive;
+    uint32_t start;
+
+    for (uint32_t i = 0; i < sizeof(g_string_src); i++) {
+        g_string_src[i] = (uint8_t)(i | 1U);    // No NUL bytes for strlen
+    }
+
+    Bench_PrintString(pHuart, "string cycles/byte: size\toptimised\tbyte loop\r\n");
+    for (uint32_t a = 0; a < sizeof(g_string_offsets) / sizeof(g_string_offsets[0]); a++) {
+        uint8_t *pDst = &g_string_dst[g_string_offsets[a][0]];
+        const uint8_t *pSrc = &g_string_src[g_string_offsets[a][1]];
+
+        Bench_PrintString(pHuart, "  dst+");
+        Bench_PrintU32(pHuart, g_string_offsets[a][0]);
+        Bench_PrintString(pHuart, " src+");
+        Bench_PrintU32(pHuart, g_string_offsets[a][1]);
+        Bench_PrintString(pHuart, "\r\n");
+
+        for (uint32_t s = 0; s < sizeof(g_string_sizes) / sizeof(g_string_sizes[0]); s++) {
+            uint32_t len = g_string_sizes[s];
+
+            DWT_CycleStatsReset(&fast);
+            DWT_CycleStatsReset(&naive);
+            for (uint32_t r = 0; r < BENCH_STRING_REPEAT; r++) {
+                start = cycles_now();
+                (void)memcpy(pDst, pSrc, len);
+                DWT_CycleStatsAdd(&fast, cycles_now() - start);
+                start = cycles_now();
+                Bench_NaiveCopy(pDst, pSrc, len);
+                DWT_CycleStatsAdd(&naive, cycles_now() - start);
+            }
+            Bench_StringRow(pHuart, "    memcpy ", len, fast.Min, naive.Min);
+
+            // Equal buffers (just copied): the whole length is compared
+            DWT_CycleStatsReset(&fast);
+            DWT_CycleStatsReset(&naive);
+            for (uint32_t r = 0; r < BENCH_STRING_REPEAT; r++) {
+                start = cycles_now();
+                g_string_sink = (uint32_t)memcmp(pDst, pSrc, len);
+                DWT_CycleStatsAdd(&fast, cycles_now() - start);
+                start = cycles_now();
+                g_string_sink = (uint32_t)Bench_NaiveCompare(pDst, pSrc, len);
+                DWT_CycleStatsAdd(&naive, cycles_now() - start);
+            }
+            Bench_StringRow(pHuart, "    memcmp ", len, fast.Min, naive.Min);
+
+            DWT_CycleStatsReset(&fast);
+            DWT_CycleStatsReset(&naive);
+            for (uint32_t r = 0; r < BENCH_STRING_REPEAT; r++) {
+                start = cycles_now();
+                (void)memset(pDst, 0x5A, len);
+                DWT_CycleStatsAdd(&fast, cycles_now() - start);
+                start = cycles_now();
+                Bench_NaiveSet(pDst, 0x5A, len);
+                DWT_CycleStatsAdd(&naive, cycles_now() - start);
+            }
+            Bench_StringRow(pHuart, "    memset ", len, fast.Min, naive.Min);
+
+            // String of len characters at the source offset
+            (void)memcpy(pDst, pSrc, len);
+            pDst[len] = '\0';
+            DWT_CycleStatsReset(&fast);
+            DWT_CycleStatsReset(&naive);
+            for (uint32_t r = 0; r < BENCH_STRING_REPEAT; r++) {
+                start = cycles_now();
+                g_string_sink = strlen((const char *)pDst);
+                DWT_CycleStatsAdd(&fast, cycles_now() - start);
+                start = cycles_now();
+                g_string_sink = Bench_NaiveLen((const char *)pDst);
+                DWT_CycleStatsAdd(&naive, cycles_now() - start);
+            }
+            Bench_StringRow(pHuart, "    strlen ", len, fast.Min, naive.Min);
+        }
+    }
+}
@@ -0,0 +1,205 @@
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Freestanding replacements for the <string.h> routines the firmware uses.
+ * The image links with -nostdlib, so these are the only definitions; GCC
+ * also calls memcpy/memset itself for struct copies and array initialisers.
+ * Word-aligned blocks move 16 bytes per LDM/STM pair. Cortex-M3 has no
+ * unaligned LDM/STM, so a source that is misaligned relative to the
+ * destination is read with aligned loads and shifted into place.
+ *
+ * This file is built with -fno-tree-loop-distribute-patterns (CMakeLists.txt)
+ * so GCC does not turn the byte loops below back into calls to themselves.
+ */
+
+#define STRING_ONES         0x01010101U
+#define STRING_HIGHS        0x80808080U
+
+// Non-zero when the word holds a zero byte
+#define STRING_HAS_ZERO(w)  (((w) - STRING_ONES) & ~(w) & STRING_HIGHS)
+
+// Word access to byte buffers without breaking strict aliasing
+typedef uint32_t __attribute__((may_alias)) String_Word_t;
+
+// Helper to copy the whole words of n bytes between word-aligned pointers, 16 bytes per LDM/STM
+static inline void String_CopyBlocks(String_Word_t *d, const String_Word_t *s, size_t n) {
+#if defined(__arm__)
+    if (n >= 16U) {
+        __asm volatile ("1:\n\t"
+                        "ldmia %1!, {r3, r4, r5, r12}\n\t"
+                        "stmia %0!, {r3, r4, r5, r12}\n\t"
+                        "subs %2, %2, #16\n\t"
+                        "cmp %2, #16\n\t"
+                        "bhs 1b"
+                        : "+r" (d), "+r" (s), "+r" (n) : : "r3", "r4", "r5", "r12", "cc", "memory");
+    }
+#else
+    while (n >= 16U) {
+        d[0] = s[0]; d[1] = s[1]; d[2] = s[2]; d[3] = s[3];
+        d += 4;
+        s += 4;
+        n -= 16U;
+    }
+#endif
+    while (n >= 4U) {
+        *d++ = *s++;
+        n -= 4U;
+    }
+}
+
+/*
+ * Helper to copy the whole words of n bytes to an aligned destination from a
+ * misaligned source: aligned loads, shifted and merged. The last load may
+ * read up to 3 bytes past the source, within the same aligned word.
+ */
+static inline void String_CopyShifted(String_Word_t *d, const uint8_t *pSrc, size_t n) {
+    uint32_t offset = (uint32_t)pSrc & 3U;
+    uint32_t rshift = offset * 8U;
+    uint32_t lshift = 32U - rshift;
+    const String_Word_t *s = (const String_Word_t *)(pSrc - offset);
+    uint32_t lo = *s++;
+
+    // Little-endian: the upper bytes of lo followed by the lower bytes of hi
+    while (n >= 4U) {
+        uint32_t hi = *s++;
+        *d++ = (lo >> rshift) | (hi << lshift);
+        lo = hi;
+        n -= 4U;
+    }
+}
+
+void *memcpy(void *restrict pDst, const void *restrict pSrc, size_t n) {
+    uint8_t *d = (uint8_t *)pDst;
+    const uint8_t *s = (const uint8_t *)pSrc;
+
+    if (n >= 8U) {
+        size_t words;
+
+        // Align the destination; stores are the expensive side
+        while (((uint32_t)d & 3U) != 0U) {
+            *d++ = *s++;
+            n--;
+        }
+
+        if (((uint32_t)s & 3U) == 0U) {
+            String_CopyBlocks((String_Word_t *)d, (const String_Word_t *)s, n);
+        } else {
+            String_CopyShifted((String_Word_t *)d, s, n);
+        }
+        words = n & ~(size_t)3U;
+        d += words;
+        s += words;
+        n -= words;
+    }
+
+    while (n > 0U) {
+        *d++ = *s++;
+        n--;
+    }
+    return pDst;
+}
+
+void *memset(void *pDst, int c, size_t n) {
+    uint8_t *d = (uint8_t *)pDst;
+    uint32_t value = (uint8_t)c;
+
+    if (n >= 8U) {
+        String_Word_t *w;
+
+        while (((uint32_t)d & 3U) != 0U) {
+            *d++ = (uint8_t)value;
+            n--;
+        }
+
+        value *= STRING_ONES;
+        w = (String_Word_t *)d;
+#if defined(__arm__)
+        if (n >= 16U) {
+            __asm volatile ("mov r3, %2\n\t"
+                            "mov r4, %2\n\t"
+                            "mov r5, %2\n\t"
+                            "mov r12, %2\n"
+                            "1:\n\t"
+                            "stmia %0!, {r3, r4, r5, r12}\n\t"
+                            "subs %1, %1, #16\n\t"
+                            "cmp %1, #16\n\t"
+                            "bhs 1b"
+                            : "+r" (w), "+r" (n) : "r" (value) : "r3", "r4", "r5", "r12", "cc", "memory");
+        }
+#else
+        while (n >= 16U) {
+            w[0] = value; w[1] = value; w[2] = value; w[3] = value;
+            w += 4;
+            n -= 16U;
+        }
+#endif
+        while (n >= 4U) {
+            *w++ = value;
+            n -= 4U;
+        }
+        d = (uint8_t *)w;
+    }
+
+    while (n > 0U) {
+        *d++ = (uint8_t)value;
+        n--;
+    }
+    return pDst;
+}
+
+int memcmp(const void *pA, const void *pB, size_t n) {
+    const uint8_t *a = (const uint8_t *)pA;
+    const uint8_t *b = (const uint8_t *)pB;
+
+    // Word compare only finds the differing word; the byte loop orders it
+    if ((n >= 8U) && ((((uint32_t)a ^ (uint32_t)b) & 3U) == 0U)) {
+        while (((uint32_t)a & 3U) != 0U) {
+            if (*a != *b) {
+                return (int)*a - (int)*b;
+            }
+            a++;
+            b++;
+            n--;
+        }
+        while ((n >= 4U) && (*(const String_Word_t *)a == *(const String_Word_t *)b)) {
+            a += 4;
+            b += 4;
+            n -= 4U;
+        }
+    }
+
+    while (n > 0U) {
+        if (*a != *b) {
+            return (int)*a - (int)*b;
+        }
+        a++;
+        b++;
+        n--;
+    }
+    return 0;
+}
+
+size_t strlen(const char *pStr) {
+    const char *p = pStr;
+    const String_Word_t *w;
+
+    while (((uint32_t)p & 3U) != 0U) {
+        if (*p == '\0') {
+            return (size_t)(p - pStr);
+        }
+        p++;
+    }
+
+    // Aligned word reads never cross into another memory region
+    w = (const String_Word_t *)p;
+    while (!STRING_HAS_ZERO(*w)) {
+        w++;
+    }
+
+    p = (const char *)w;
+    while (*p != '\0') {
+        p++;
+    }
+    return (size_t)(p - pStr);
+}
@@ -4,21 +4,34 @@
 #include "timer.h"
 #include "uart.h"
 #include "systick.h"
+#include "lowpower.h"
+#include "nvic.h"
+#ifdef BENCHMARKS
+#include "bench/bench.h"
+#endif
 #include <string.h>
 
 // Global Handles
 UART_Handle_t huart1;
 
-void SystemClock_Config(void); // Defined in rcc.c (assumed) or we rely on default
+// USART1 vector: RX bytes go to huart1's ring buffer, TX drains it
+void v_v_usart1_handler(void) {
+    UART_IRQHandler(&huart1);
+}
 
 int main(void) {
     // 1. System Clock Config
-    // SystemClock_Config(); // Assuming already configured or default 72MHz setup if available
-    // For now, we assume 72MHz or default HSI. If default HSI (8MHz), prescalers need adjustment.
-    // Let's assume the user has a startup file that calls SystemInit.
-    
-    // Initialize SysTick for delay_ms (assuming 72MHz clock)
-    SysTick_Init(72000000);
+    // 72MHz from HSE + PLL, or HSI 8MHz if the crystal does not start.
+    // Drivers read the resulting frequencies with RCC_GetClocksFreq.
+    SystemClock_Config();
+
+#ifdef NVIC_RAM_VECTORS
+    // Handlers can now be swapped at runtime with NVIC_SetVector
+    NVIC_RelocateVectorTable();
+#endif
+
+    // 1 kHz SysTick: millis(), timeouts and delay_ms from the actual HCLK
+    SysTick_Init();
 
     // 2. GPIO Init
     GPIO_Handle_t GpioLed, GpioUartTx, GpioUartRx;
@@ -58,22 +71,43 @@ int main(void) {
     char msg[] = "Hello from STM32 UART Driver!\r\n";
     UART_Transmit(&huart1, (uint8_t*)msg, strlen(msg));
 
+#ifdef BENCHMARKS
+    // Results go out on UART1; does not return
+    Bench_RunAll(&huart1);
+#endif
+
+    // Interrupt-driven echo from here on
+    UART_EnableIT(&huart1);
+    UART_IRQPriorityConfig(IRQ_NO_USART1, NVIC_CRITICAL_PRIORITY);
+    UART_IRQInterruptConfig(IRQ_NO_USART1, ENABLE);
+
+    // Tickless idle between deadlines (no RTC configured: WFI only)
+    LP_Init(0);
+
+    timeout_t ledTimeout;
+    timeout_start(&ledTimeout, 500);
+
     while(1) {
-        // Blink LED
-        GPIO_ToggleOutputPin(GPIOC, GPIO_PIN_13);
-        
+        // Blink LED every 500ms without blocking the loop
+        if (timeout_expired(&ledTimeout)) {
+            GPIO_ToggleOutputPin(GPIOC, GPIO_PIN_13);
+            timeout_restart(&ledTimeout);
+        }
+
         // Send Heartbeat
         // UART_Transmit(&huart1, (uint8_t*)"Tick\r\n", 6);
 
-        // Echo Check
-        // Note: This is blocking receive for 1 byte, might stall the loop if no data.
-        // For testing, we can check RXNE flag manually or just rely on blink.
-        if (USART1->SR & USART_SR_RXNE) {
-            uint8_t data = UART_ReceiveByte(&huart1);
-            UART_Transmit(&huart1, &data, 1); // Echo back
+        // Echo back whatever the RX interrupt queued (and TX has room for)
+        uint8_t data[16];
+        uint32_t len = UART_TxFree(&huart1);
+        if (len > sizeof(data)) len = sizeof(data);
+        len = UART_Read(&huart1, data, len);
+        if (len != 0) {
+            (void)UART_Write(&huart1, data, len);
         }
 
-        delay_ms(500);
+        // Sleep until the next deadline; a received byte wakes the core early
+        LP_Idle(timeout_remaining(&ledTimeout));
     }
 }
 
@@ -0,0 +1,158 @@
+/*
+ * Host-side stress test for drivers/inc/lfqueue.h: producers and the
+ * consumer run on separate pthreads (real parallelism, so the host fences
+ * and __atomic CAS of the header are exercised). Every queue must deliver
+ * each item exactly once and, per producer, in order.
+ *
+ * Build and run with tests/host/Makefile (make -C tests/host).
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include "lfqueue.h"
+
+#define STRESS_ITEMS            2000000U
+#define STRESS_PRODUCERS        4U
+#define STRESS_QUEUE_SIZE       64U
+
+LFQ_SPSC_DEFINE(StressQueue, uint32_t, STRESS_QUEUE_SIZE);
+
+static LFQ_Spsc_t g_byte_queue;
+static uint8_t g_byte_buffer[STRESS_QUEUE_SIZE];
+static StressQueue_t g_elem_queue;
+static LFQ_Mpsc_t g_mpsc_queue;
+static LFQ_MpscCell_t g_mpsc_cells[STRESS_QUEUE_SIZE];
+
+// Byte ring producer: alternates single puts and block writes of a counting pattern
+static void *Stress_ByteProducer(void *pArg) {
+    uint32_t sent = 0;
+    uint8_t block[7];
+
+    while (sent < STRESS_ITEMS) {
+        if ((sent & 1U) == 0U) {
+            if (!LFQ_SpscPut(&g_byte_queue, (uint8_t)sent)) {
+                sched_yield();
+                continue;
+            }
+            sent++;
+        } else {
+            uint16_t len = (uint16_t)((STRESS_ITEMS - sent < sizeof(block)) ? (STRESS_ITEMS - sent) : sizeof(block));
+            for (uint16_t i = 0; i < len; i++) {
+                block[i] = (uint8_t)(sent + i);
+            }
+            sent += LFQ_SpscWrite(&g_byte_queue, block, len);
+        }
+    }
+    return pArg;
+}
+
+static void *Stress_ElemProducer(void *pArg) {
+    for (uint32_t i = 0; i < STRESS_ITEMS; ) {
+        if (StressQueue_Put(&g_elem_queue, &i)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return pArg;
+}
+
+// MPSC producer: the top nibble tags the producer, the rest counts
+static void *Stress_MpscProducer(void *pArg) {
+    uint32_t id = (uint32_t)(uintptr_t)pArg;
+
+    for (uint32_t i = 0; i < STRESS_ITEMS / STRESS_PRODUCERS; ) {
+        if (LFQ_MpscPut(&g_mpsc_queue, (id << 28) | i)) {
+            i++;
+        } else {
+            sched_yield();
+        }
+    }
+    return 0;
+}
+
+static int Stress_Byte(void) {
+    pthread_t producer;
+    uint32_t expected = 0;
+    uint8_t data[5];
+
+    LFQ_SpscInit(&g_byte_queue, g_byte_buffer, sizeof(g_byte_buffer));
+    pthread_create(&producer, 0, Stress_ByteProducer, 0);
+    while (expected < STRESS_ITEMS) {
+        uint16_t len = LFQ_SpscRead(&g_byte_queue, data, sizeof(data));
+        if (len == 0U) {
+            sched_yield();
+        }
+        for (uint16_t i = 0; i < len; i++, expected++) {
+            if (data[i] != (uint8_t)expected) {
+                printf("spsc byte: got %u at %u\n", data[i], expected);
+                return 1;
+            }
+        }
+    }
+    pthread_join(producer, 0);
+    return 0;
+}
+
+static int Stress_Elem(void) {
+    pthread_t producer;
+    uint32_t expected = 0;
+    uint32_t value;
+
+    pthread_create(&producer, 0, Stress_ElemProducer, 0);
+    while (expected < STRESS_ITEMS) {
+        if (!StressQueue_Get(&g_elem_queue, &value)) {
+            sched_yield();
+            continue;
+        }
+        if (value != expected) {
+            printf("spsc element: got %u, expected %u\n", value, expected);
+            return 1;
+        }
+        expected++;
+    }
+    pthread_join(producer, 0);
+    return 0;
+}
+
+static int Stress_Mpsc(void) {
+    pthread_t producers[STRESS_PRODUCERS];
+    uint32_t next[STRESS_PRODUCERS] = {0};
+    uint32_t received = 0;
+    uint32_t value;
+
+    LFQ_MpscInit(&g_mpsc_queue, g_mpsc_cells, STRESS_QUEUE_SIZE);
+    for (uint32_t i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_create(&producers[i], 0, Stress_MpscProducer, (void *)(uintptr_t)i);
+    }
+    while (received < STRESS_ITEMS) {
+        uint32_t id, seq;
+
+        if (!LFQ_MpscGet(&g_mpsc_queue, &value)) {
+            sched_yield();
+            continue;
+        }
+        id = value >> 28;
+        seq = value & 0x0FFFFFFFU;
+        if ((id >= STRESS_PRODUCERS) || (seq != next[id])) {
+            printf("mpsc: producer %u sent %u, expected %u\n", id, seq, (id < STRESS_PRODUCERS) ? next[id] : 0U);
+            return 1;
+        }
+        next[id]++;
+        received++;
+    }
+    for (uint32_t i = 0; i < STRESS_PRODUCERS; i++) {
+        pthread_join(producers[i], 0);
+    }
+    return 0;
+}
+
+int main(void) {
+    int failed = 0;
+
+    failed |= Stress_Byte();
+    failed |= Stress_Elem();
+    failed |= Stress_Mpsc();
+    printf("lfqueue stress: %s\n", failed ? "FAILED" : "ok");
+    return failed;
+}
@@ -20,7 +20,7 @@ set(CMAKE_ASM_FLAGS "${COMMON_FLAGS} -g3" CACHE INTERNAL "ASM compiler flags")
 
 # Set linker flags
 set(LINKER_SCRIPT "${CMAKE_SOURCE_DIR}/linker/linker.ld")
-set(CMAKE_EXE_LINKER_FLAGS "-nostdlib --specs=nosys.specs -Wl,-Map=${PROJECT_NAME}.map -Wl,--gc-sections -T ${LINKER_SCRIPT} ${COMMON_FLAGS}" CACHE INTERNAL "Linker flags")
+set(CMAKE_EXE_LINKER_FLAGS "-nostdlib --specs=nosys.specs -Wl,-Map=${PROJECT_NAME}.map -Wl,--gc-sections -Wl,--print-memory-usage -T ${LINKER_SCRIPT} ${COMMON_FLAGS}" CACHE INTERNAL "Linker flags")
 
 # Set build type defaults
 if(NOT CMAKE_BUILD_TYPE)